@@ -1,13 +0,0 @@
-%module DevIL
-%{
-#include "il.h"
-#include "ilu.h"
-#include "ilut.h"
-//#include "ilu_region.h"
-%}
-
-%include "il.h"
-%include "ilu.h"
-%include "ilut.h"
-//%include "ilu_region.h"
-
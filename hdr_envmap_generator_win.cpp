@@ -4,10 +4,30 @@
 #include <iostream>
 #include <string>
 #include <string.h>
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include "glad/glad.h"
 #include "GLFW/glfw3.h"
 
+#include "src\cpp\costModel.h"
 #include "src\cpp\generator.h"
+#include "src\cpp\glBackend.h"
+#include "src\cpp\jobServer.h"
+#include "src\cpp\parallel.h"
+#include "src\cpp\probeBatch.h"
+#include "src\cpp\cpuConverter.h"
+#include "src\cpp\fileSystem.h"
+#include "src\cpp\fastMath.h"
+#include "src\cpp\report.h"
+#include "src\cpp\sampleSchedule.h"
+#include "src\cpp\shaderSources.h"
 
 const std::string help = "\n"
 "This program converts and saves several cube maps from an\n"
@@ -23,68 +43,600 @@ const std::string help = "\n"
 "-out [path where to save to]     Define the output path. Default is .\out in the programs root directory.\n"
 "-mips [n]                        Number of generated prefiltered maps. Default is 6.\n"
 "-irr_res [n]                     Resolution of the irradiance maps squares. Default is 64.\n"
+"-face-size [n]                   Side width of the background and prefiltered cubes. Default is 1/4th of the source width.\n"
+"-ladder [n,n,...]                Generate several face sizes, e.g. 2048,1024,512. The largest one runs the full\n"
+"                                 pipeline, the smaller ones are downsampled from it. Each goes to [out]/[n].\n"
+"-cpu-mips                        Build the mip chain of the background cube seam aware on the CPU.\n"
+"-backend [gl|cpu|gl,cpu]         The engine doing the image processing. Default is gl. Several backends\n"
+"                                 run one after another on the same job, each into [out]/[backend].\n"
+"-stream                          Convert only the background cube on the CPU while streaming the source.\n"
+"-mem-budget [MB]                 Like -stream, but limits the resident memory to the given budget.\n"
+"-math [exact|high|fast]          Approximation of atan2 and asin for the direction to UV mapping on the CPU.\n"
+"                                 Default is exact.\n"
+"-low-mem                         Free caches and pooled textures after every stage. Lower peak memory, slower.\n"
+"-compare-variants                Also render every prefiltered level with the generic shader and report the gain of the\n"
+"                                 variant specialized for its roughness.\n"
+"-glsl-dir [path]                 Read shaders found there instead of the built in ones, e.g. src\\glsl.\n"
+"-samples [full|auto|n,n,...]     GGX samples per prefiltered level. auto derives them from the roughness and the texel\n"
+"                                 size of the level, a list sets them per level. Default is full, 8192 everywhere.\n"
+"-sample-error                    Also prefilter with 8192 samples and report the error of every level against it.\n"
+"-irradiance [conv|sh]            Irradiance from the hemisphere convolution or from spherical harmonics. Default is conv.\n"
+"-time-budget [ms]                Lower the irradiance method, the samples and the face size until the job is predicted\n"
+"                                 to fit. The prediction uses the stage times of previous runs.\n"
+"-progressive                     Write a 128px preview of every product first and replace it by bigger passes until\n"
+"                                 the full quality is written. The time of every pass is logged.\n"
+"-batch [n]                       Probes per batch of -probes. Default is as many as fit into 256 MB, 0 runs them one\n"
+"                                 after another through the usual stages.\n"
+"\n"
+"Usage: .\\hdr_envmap_generator_win.exe -bench-math [face size]\n"
+"\n"
+"Measures the worst UV error in source texels and the throughput of every -math precision. Default face size is 4096.\n"
+"\n"
+"Usage: .\\hdr_envmap_generator_win.exe -serve [socket path] [-backend gl|cpu] [-queue n] [-parallel n] [-glsl-dir path]\n"
+"\n"
+"Keeps one backend warm and runs jobs sent over a Unix domain socket, default hdr_envmap_generator.sock. A job is one\n"
+"line with the input path and the parameters above, jobs beyond the queue size (default 16) are rejected. The client\n"
+"gets the queue position, the report and the time of its job. SIGTERM lets the queued jobs finish, then stops.\n"
+"-parallel runs n jobs at the same time, each on a backend of its own with 1/n of the cores. Default is 1.\n"
+"-glsl-dir applies to all jobs, jobs which set it themselves are rejected.\n"
+"\n"
+"Usage: .\\hdr_envmap_generator_win.exe -probes [list file] [-batch n] [parameters]\n"
+"\n"
+"Converts many small light probes of one size, the list has a .hdr path per line. The products of all probes are\n"
+"packed into [out]/background_[list].hdr, irradiance_[list].hdr and environment_[list].hdr with a row block per\n"
+"probe, probes_[list].txt tells the layout. -out, -mips, -irr_res, -face-size, -backend, -math, -low-mem, -cpu-mips,\n"
+"-samples, -irradiance and -batch apply.\n"
 "\n";
 
-int main(int argc, char *argv[])
+/**
+* Converts the source to the background cube on the CPU without loading it at once.
+* This works for sources which are too big for the OpenGL path. A failed conversion returns its error code and leaves
+* earlier outputs in place.
+**/
+int runStreamingConversion(const std::string& in, const std::string& out, int faceSize, std::size_t memBudget, fastMath::Precision precision)
 {
-    if (argc == 1) {
-        std::cout << help;
-        return 0;
+    fileSystem::makeDirectories(out);
+
+    std::size_t sepPos = in.rfind('/');
+    std::string name = in.substr(sepPos == std::string::npos ? 0 : sepPos + 1);
+    name = name.substr(0, name.rfind(".hdr"));
+
+    Report report;
+    Timer timer;
+    CpuConverter converter(in);
+    converter.setFaceSize(faceSize);
+    converter.setMemoryBudget(memBudget);
+    converter.setMathPrecision(precision);
+    try {
+        converter.convert(out + "/background_" + name, report);
     }
-    
-    // Convert escape character
-    char c = '0';
-    unsigned int i = 0;
-    while (c != '\0') {
-        c = argv[1][i];
-        if (c == '\\') {
-            argv[1][i] = '/';
-        }
-        i++;
+    catch (int eCode) {
+        // The converter removed its scratch files and the unwound writers their temporary ones
+        std::cout << "ERROR: Streaming conversion failed with code " << eCode << std::endl;
+        return eCode;
     }
-    
-    // Init the program
-    Generator g(argv[1]);
+    report.addTiming("total", timer.elapsedMs());
+    report.print(std::cout);
+    return 0;
+}
 
+/**
+* The parameters of a job, see help.
+**/
+struct Options {
+    std::string outPath = "out";
+    int mips = 6;
     int irradianceRes = 64;
+    int faceSize = 0;
+    std::vector<int> ladder;
+    bool cpuMips = false;
+    bool stream = false;
+    std::size_t memBudget = 0;
+    std::vector<std::string> backends;
+    fastMath::Precision precision = fastMath::Precision::Exact;
+    bool lowMemory = false;
+    bool compareVariants = false;
+    sampleSchedule::Spec schedule;
+    bool sampleError = false;
+    IrradianceMethod irradianceMethod = IrradianceMethod::Convolution;
+    double timeBudget = 0.0;
+    bool progressive = false;
+    int batchSize = -1;
+    /// Applies to the whole process, so only the command line may set it, see shaderSources::setOverrideDirectory.
+    std::string glslDirectory;
+};
+
+/// The largest face size a job may ask for, the biggest cube map size of common GPUs.
+const int maxFaceSize = 16384;
 
-    // Set the members
-    for (int i = 2; i < argc; i++) {
-        if (strcmp(argv[i], "-out") == 0) {
-            g.setOutPath(argv[i + 1]);
+/**
+* Reads a whole number within limits. Jobs of -serve come from clients, so a negative or huge value must not reach
+* the unsigned setters and the allocations.
+*
+* \param const std::string& arg The parameter, for the error
+* \param const std::string& value The text of the value
+* \param long lowest, highest The allowed range
+* \param int& result Receives the value
+* \return false with an error printed if the value is no number or out of range
+**/
+bool parseCount(const std::string& arg, const std::string& value, long lowest, long highest, int& result)
+{
+    char* end = nullptr;
+    const long number = std::strtol(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || number < lowest || number > highest) {
+        std::cout << "ERROR: " << arg << " takes a number from " << lowest << " to " << highest << ", not: " << value << std::endl;
+        return false;
+    }
+    result = (int)number;
+    return true;
+}
+
+/**
+* Reads the parameters following the input path.
+*
+* \param const std::vector<std::string>& args The parameters
+* \param Options& options Receives the values, parameters not given keep theirs
+* \return false with an error printed if a value is invalid
+**/
+bool parseOptions(const std::vector<std::string>& args, Options& options)
+{
+    for (std::size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        // A flag without its value reads an empty one
+        const std::string value = i + 1 < args.size() ? args[i + 1] : std::string();
+        if (arg == "-out") {
+            options.outPath = value;
+        }
+        else if (arg == "-mips") {
+            if (!parseCount(arg, value, 1, 16, options.mips)) {
+                return false;
+            }
         }
-        else if (strcmp(argv[i], "-mips") == 0) {
-            g.setMaxMipLevels(atoi(argv[i + 1]));
+        else if (arg == "-irr_res") {
+            if (!parseCount(arg, value, 1, 4096, options.irradianceRes)) {
+                return false;
+            }
         }
-        else if (strcmp(argv[i], "-irr_res") == 0) {
-            irradianceRes = atoi(argv[i + 1]);
+        else if (arg == "-face-size") {
+            if (!parseCount(arg, value, 1, maxFaceSize, options.faceSize)) {
+                return false;
+            }
+        }
+        else if (arg == "-ladder") {
+            std::stringstream sizes(value);
+            std::string size;
+            options.ladder.clear();
+            while (std::getline(sizes, size, ',')) {
+                int faceSize = 0;
+                if (!parseCount(arg, size, 1, maxFaceSize, faceSize)) {
+                    return false;
+                }
+                options.ladder.push_back(faceSize);
+            }
+            if (options.ladder.empty()) {
+                std::cout << "ERROR: Empty ladder" << std::endl;
+                return false;
+            }
+            std::sort(options.ladder.begin(), options.ladder.end(), std::greater<int>());
+            options.faceSize = options.ladder.front();
+        }
+        else if (arg == "-cpu-mips") {
+            options.cpuMips = true;
+        }
+        else if (arg == "-backend") {
+            std::stringstream names(value);
+            std::string name;
+            options.backends.clear();
+            while (std::getline(names, name, ',')) {
+                options.backends.push_back(name);
+            }
+        }
+        else if (arg == "-stream") {
+            options.stream = true;
+        }
+        else if (arg == "-mem-budget") {
+            int megabytes = 0;
+            if (!parseCount(arg, value, 1, 1024 * 1024, megabytes)) {
+                return false;
+            }
+            options.stream = true;
+            options.memBudget = std::size_t(megabytes) * 1024 * 1024;
+        }
+        else if (arg == "-math") {
+            if (!fastMath::parsePrecision(value, options.precision)) {
+                std::cout << "ERROR: Unknown math precision: " << value << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "-low-mem") {
+            options.lowMemory = true;
+        }
+        else if (arg == "-compare-variants") {
+            options.compareVariants = true;
+        }
+        else if (arg == "-glsl-dir") {
+            options.glslDirectory = value;
+        }
+        else if (arg == "-samples") {
+            if (!sampleSchedule::parse(value, options.schedule)) {
+                std::cout << "ERROR: Unknown sample schedule: " << value << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "-sample-error") {
+            options.sampleError = true;
+        }
+        else if (arg == "-irradiance") {
+            if (value == "conv") {
+                options.irradianceMethod = IrradianceMethod::Convolution;
+            }
+            else if (value == "sh") {
+                options.irradianceMethod = IrradianceMethod::SphericalHarmonics;
+            }
+            else {
+                std::cout << "ERROR: Unknown irradiance method: " << value << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "-time-budget") {
+            options.timeBudget = atof(value.c_str());
+            if (!(options.timeBudget > 0.0)) {
+                std::cout << "ERROR: -time-budget takes a positive number of ms, not: " << value << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "-progressive") {
+            options.progressive = true;
+        }
+        else if (arg == "-batch") {
+            if (!parseCount(arg, value, 0, 4096, options.batchSize)) {
+                return false;
+            }
         }
     }
+    return true;
+}
 
+/**
+* Converts the light probes listed in a file into packed files, see help.
+**/
+int runProbes(const std::string& list, const Options& options)
+{
+    std::ifstream file(list);
+    if (!file) {
+        std::cout << "ERROR: Could not open: " << list << std::endl;
+        return 1;
+    }
+    std::vector<std::string> inputs;
+    std::string line;
+    while (std::getline(file, line)) {
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::replace(line.begin(), line.end(), '\\', '/');
+        inputs.push_back(line);
+    }
+    std::size_t sepPos = list.find_last_of("/\\");
+    std::string name = list.substr(sepPos == std::string::npos ? 0 : sepPos + 1);
+    name = name.substr(0, name.rfind('.'));
+
+    Report report;
+    Arena arena;
+    Timer timer;
+    const std::string backendName = options.backends.empty() ? "gl" : options.backends.front();
+    std::unique_ptr<Backend> backend = Backend::create(backendName, report, arena);
+    if (!backend) {
+        std::cout << "ERROR: Unknown backend: " << backendName << std::endl;
+        return 1;
+    }
+    ProbeBatch probes(inputs, *backend, report, arena);
+    probes.setFaceSize(options.faceSize);
+    probes.setIrradianceSize(options.irradianceRes);
+    probes.setMipLevels(options.mips);
+    probes.setBatchSize(options.batchSize);
+    backend->setSampleCounts(sampleSchedule::build(options.schedule, probes.getFaceSize(), options.mips));
+    backend->setIrradianceMethod(options.irradianceMethod);
+    backend->setCpuMipmaps(options.cpuMips);
+    backend->setMathPrecision(options.precision);
+    backend->setLowMemory(options.lowMemory);
+    probes.run(options.outPath, name);
+    report.addTiming("total", timer.elapsedMs());
+    std::cout << "Backend " << backendName << std::endl;
+    report.print(std::cout);
+    return 0;
+}
+
+/**
+* Runs one job on a generator, including the smaller tiers of a ladder. The generator may have run jobs before.
+**/
+void runJob(Generator& g, const std::string& in, const std::string& outPath, const Options& options, CostModel& costModel)
+{
+    // The budget covers loading the source as well
+    Timer jobTimer;
+    const std::vector<int>& ladder = options.ladder;
+    g.loadSource(in);
+    g.setOutPath(ladder.empty() ? outPath : outPath + "\\" + std::to_string(options.faceSize));
+    g.setMaxMipLevels(options.mips);
+    g.setFaceSize(options.faceSize);
+    g.setCpuMipmaps(options.cpuMips);
+    g.setMathPrecision(options.precision);
+    g.setLowMemory(options.lowMemory);
+    g.setCompareShaderVariants(options.compareVariants);
+    g.setSampleSchedule(options.schedule);
+    g.setSampleErrorReport(options.sampleError);
+    g.setIrradianceMethod(options.irradianceMethod);
+    g.setCostModel(&costModel);
+    const int irradianceRes = options.irradianceRes;
+    if (options.timeBudget > 0.0) {
+        // The tiers of a ladder keep their sizes
+        g.fitTimeBudget(options.timeBudget, jobTimer.elapsedMs(), irradianceRes, !ladder.empty());
+    }
+
+    // Every pass is four times bigger with four times the samples, so all of them cost a fraction of the full pipeline
+    unsigned int pass = 0;
+    for (unsigned int size = 128, samples = 256; options.progressive && size < g.getFaceSize(); size *= 4, samples = std::min(samples * 4, 8192u)) {
+        g.generatePreview(size, samples, irradianceRes);
+        const std::string name = "progressive pass " + std::to_string(pass++) + " (" + std::to_string(size) + "px, " + std::to_string(samples) + " samples)";
+        std::cout << name << " written after " << jobTimer.elapsedMs() << " ms" << std::endl;
+        g.getReport().addTiming(name + " written", jobTimer.elapsedMs());
+    }
+
+    // Every product is freed after its last use. The tiers of a ladder are derived from and save all of them.
+    const bool lastTier = ladder.size() <= 1;
+    Timer timer;
     g.generateCubeMap();
     g.saveCubeMap();
     g.generateIrradianceMap(irradianceRes);
     g.saveIrradianceMap();
-    g.generateEnvironmentMap();
+    if (lastTier) {
+        g.releaseProduct(Product::Irradiance);
+    }
+    g.generateEnvironmentMap(lastTier);
     g.savePrefilteredEnvMap();
+    if (lastTier) {
+        g.releaseProduct(Product::Prefiltered);
+    }
+    g.getReport().addTiming("face size " + std::to_string(g.getFaceSize()) + " (full pipeline)", timer.elapsedMs());
+    g.reportTimeBudget(jobTimer.elapsedMs());
+    if (options.progressive) {
+        const std::string name = "progressive pass " + std::to_string(pass) + " (" + std::to_string(g.getFaceSize()) + "px, final)";
+        std::cout << name << " written after " << jobTimer.elapsedMs() << " ms" << std::endl;
+        g.getReport().addTiming(name + " written", jobTimer.elapsedMs());
+    }
+
+    // The smaller tiers are derived from the previous one
+    for (std::size_t tier = 1; tier < ladder.size(); ++tier) {
+        timer.restart();
+        g.generateLadderTier(ladder[tier]);
+        g.setOutPath(outPath + "\\" + std::to_string(ladder[tier]));
+        g.saveCubeMap();
+        g.saveIrradianceMap();
+        g.savePrefilteredEnvMap();
+        g.getReport().addTiming("face size " + std::to_string(ladder[tier]) + " (downsampled)", timer.elapsedMs());
+    }
+    g.reportMemory();
+}
+
+/**
+* Runs the whole pipeline on one backend.
+**/
+void runPipeline(const std::string& in, const std::string& outPath, const std::string& backend, const Options& options, CostModel& costModel, Arena& arena)
+{
+    // Init the program
+    Generator g(backend, &arena);
+    runJob(g, in, outPath, options, costModel);
+    std::cout << "Backend " << backend << std::endl;
+    g.getReport().print(std::cout);
 
 // If no debug build, show and keep the window open.
 #if defined (_DEBUG) && defined (_WIN32)
-    glfwShowWindow(g.getWindow());
+    GLBackend* gl = dynamic_cast<GLBackend*>(g.getBackend());
+    if (gl == nullptr) {
+        return;
+    }
+    glfwShowWindow(gl->getWindow());
 
-    while (!glfwWindowShouldClose(g.getWindow()))
+    while (!glfwWindowShouldClose(gl->getWindow()))
     {
-        g.processWindowInput();
+        gl->processWindowInput();
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glViewport(0, 0, 800, 600);
 
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        g.renderSkybox();
+        gl->renderSkybox();
 
         glfwPollEvents();
     }
 #endif //Debug
+}
+
+/**
+* Runs the jobs of a JobServer on a warm generator until the server stops.
+**/
+void serveJobs(JobServer& server, Generator& g, const std::string& backend, unsigned int threads, CostModel& costModel)
+{
+    parallel::setThreadCount(threads);
+    g.attachThread();
+    JobServer::Job job;
+    while (server.next(job)) {
+        Timer jobTimer;
+        g.getReport().clear();
+        std::string in = job.args.front();
+        std::replace(in.begin(), in.end(), '\\', '/');
+        Options options;
+        bool ok = parseOptions(std::vector<std::string>(job.args.begin() + 1, job.args.end()), options);
+        if (ok && (options.stream || options.backends.size() > 1 || (options.backends.size() == 1 && options.backends.front() != backend))) {
+            // The warm generator has one backend, streaming does not use it at all
+            std::cout << "ERROR: -stream and other backends are not served" << std::endl;
+            ok = false;
+        }
+        if (ok && !options.glslDirectory.empty()) {
+            // The shaders of all following jobs and of the other workers would change
+            std::cout << "ERROR: -glsl-dir is only taken on the command line of the server" << std::endl;
+            ok = false;
+        }
+        if (ok) {
+            try {
+                runJob(g, in, options.outPath, options, costModel);
+            }
+            catch (int eCode) {
+                std::cout << "ERROR: Job " << job.id << " failed with code " << eCode << std::endl;
+                ok = false;
+            }
+            // Out of memory or anything else a job throws must not take the server and the queued jobs down
+            catch (const std::exception& e) {
+                std::cout << "ERROR: Job " << job.id << " failed: " << e.what() << std::endl;
+                ok = false;
+            }
+            catch (...) {
+                std::cout << "ERROR: Job " << job.id << " failed" << std::endl;
+                ok = false;
+            }
+        }
+        g.getReport().addTiming("job", jobTimer.elapsedMs());
+        std::cout << "Job " << job.id << (ok ? " done" : " failed") << " after " << jobTimer.elapsedMs() << " ms" << std::endl;
+        server.finish(job, ok, jobTimer.elapsedMs(), g.getReport());
+        costModel.save();
+    }
+    g.detachThread();
+}
+
+/**
+* Keeps generators warm and runs the jobs of a JobServer until SIGTERM, see help.
+**/
+int runServer(const std::vector<std::string>& args)
+{
+    std::string socketPath = "hdr_envmap_generator.sock";
+    std::string backend = "gl";
+    std::size_t capacity = 16;
+    unsigned int workers = 1;
+    for (std::size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "-backend" && i + 1 < args.size()) {
+            backend = args[++i];
+        }
+        else if (args[i] == "-queue" && i + 1 < args.size()) {
+            capacity = std::max(atoi(args[++i].c_str()), 1);
+        }
+        else if (args[i] == "-parallel" && i + 1 < args.size()) {
+            workers = std::max(atoi(args[++i].c_str()), 1);
+        }
+        else if (args[i] == "-glsl-dir" && i + 1 < args.size()) {
+            shaderSources::setOverrideDirectory(args[++i]);
+        }
+        else if (args[i][0] != '-') {
+            socketPath = args[i];
+        }
+    }
+
+    // Every worker gets a share of the cores, a job alone does not keep all of them busy through its serial stages
+    const unsigned int threads = std::max(parallel::threadCount() / workers, 1u);
+    // The contexts, the programs and the pools live across all jobs. GLFW wants them created on the main thread.
+    std::vector<std::unique_ptr<Arena>> arenas;
+    std::vector<std::unique_ptr<Generator>> generators;
+    Timer startTimer;
+    parallel::setThreadCount(threads);
+    for (unsigned int worker = 0; worker < workers; ++worker) {
+        arenas.emplace_back(new Arena());
+        generators.emplace_back(new Generator(backend, arenas.back().get()));
+        generators.back()->detachThread();
+    }
+    parallel::setThreadCount(0);
+    generators.front()->getReport().addTiming("server start", startTimer.elapsedMs());
+    generators.front()->getReport().print(std::cout);
+    CostModel costModel("./costmodel.txt");
+
+    JobServer server(socketPath, capacity);
+    if (!server.start()) {
+        return 1;
+    }
+    std::cout << "Serving on " << socketPath << " with backend " << backend << ", " << workers << " workers of " << threads
+        << " threads, queue " << capacity << std::endl;
+
+    Timer serveTimer;
+    std::vector<std::thread> workerThreads;
+    for (unsigned int worker = 0; worker < workers; ++worker) {
+        workerThreads.emplace_back(serveJobs, std::ref(server), std::ref(*generators[worker]), std::cref(backend), threads, std::ref(costModel));
+    }
+    for (std::thread& thread : workerThreads) {
+        thread.join();
+    }
+    std::cout << "Stopped, all queued jobs are done after " << serveTimer.elapsedMs() << " ms" << std::endl;
+    // The contexts go on the main thread as well
+    for (std::unique_ptr<Generator>& g : generators) {
+        g.reset();
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 1) {
+        std::cout << help;
+        return 0;
+    }
+    if (strcmp(argv[1], "-bench-math") == 0) {
+        Report report;
+        fastMath::benchmark(argc > 2 ? atoi(argv[2]) : 4096, report);
+        report.print(std::cout);
+        return 0;
+    }
+    if (strcmp(argv[1], "-serve") == 0) {
+        return runServer(std::vector<std::string>(argv + 2, argv + argc));
+    }
+    if (strcmp(argv[1], "-probes") == 0) {
+        Options options;
+        if (argc < 3 || !parseOptions(std::vector<std::string>(argv + 3, argv + argc), options)) {
+            return 1;
+        }
+        if (!options.glslDirectory.empty()) {
+            shaderSources::setOverrideDirectory(options.glslDirectory);
+        }
+        return runProbes(argv[2], options);
+    }
+    
+    // Convert escape character
+    char c = '0';
+    unsigned int i = 0;
+    while (c != '\0') {
+        c = argv[1][i];
+        if (c == '\\') {
+            argv[1][i] = '/';
+        }
+        i++;
+    }
+    
+    // Read the parameters
+    Options options;
+    if (!parseOptions(std::vector<std::string>(argv + 2, argv + argc), options)) {
+        return 1;
+    }
+    if (!options.glslDirectory.empty()) {
+        shaderSources::setOverrideDirectory(options.glslDirectory);
+    }
+    const std::string& outPath = options.outPath;
+
+    if (options.stream) {
+        return runStreamingConversion(argv[1], outPath, options.faceSize, options.memBudget, options.precision);
+    }
+
+    std::vector<std::string> backends = options.backends;
+    if (backends.empty()) {
+        backends.push_back("gl");
+    }
+    // One arena for all jobs, every job starts by resetting it
+    Arena arena;
+    // Every job calibrates the stage times for the next -time-budget
+    CostModel costModel("./costmodel.txt");
+    for (const std::string& backend : backends) {
+        // Side by side runs must not overwrite each other
+        if (backends.size() > 1) {
+            fileSystem::makeDirectories(outPath);
+        }
+        runPipeline(argv[1], backends.size() > 1 ? outPath + "\\" + backend : outPath, backend, options, costModel, arena);
+        costModel.save();
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+// Include own header
+#include "./arena.h"
+// Include standard libraries
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+namespace {
+    /// The alignment of every allocation in bytes.
+    const std::size_t alignment = 64;
+    /// The chunk size of the scratch arenas. Kernel temporaries are rows and tiles, not images.
+    const std::size_t scratchChunkBytes = 1u << 20;
+
+    std::atomic<std::size_t> scratchPeak(0);
+    std::atomic<std::size_t> scratchTotal(0);
+
+    /// The arenas ScratchLease lends, they are only created while more threads than before hold a lease.
+    std::mutex leaseMutex;
+    std::vector<std::unique_ptr<Arena>> idleArenas;
+    /// The arena lent to the calling thread, if any.
+    thread_local Arena* lentArena = nullptr;
+
+    /// The deleter of arena buffers, the memory belongs to the arena.
+    void keep(float*) {}
+}
+
+Arena::Arena(std::size_t chunkBytes) : chunkBytes(std::max(chunkBytes, alignment)) {}
+
+Arena& Arena::scratch() {
+    if (lentArena != nullptr) {
+        return *lentArena;
+    }
+    thread_local Arena arena(scratchChunkBytes);
+    arena.isScratch = true;
+    return arena;
+}
+
+void* Arena::allocate(std::size_t bytes) {
+    const std::size_t size = (std::max(bytes, std::size_t(1)) + alignment - 1) / alignment * alignment;
+    // Skip chunks which are too small, their rest counts as used until the arena is rewound
+    while (this->current < this->chunks.size() && this->offset + size > this->chunks[this->current].bytes) {
+        this->used += this->chunks[this->current].bytes - this->offset;
+        this->current++;
+        this->offset = 0;
+    }
+    if (this->current == this->chunks.size()) {
+        Chunk chunk;
+        chunk.bytes = std::max(this->chunkBytes, size);
+        chunk.memory = PlanarImage::allocate(chunk.bytes / sizeof(float));
+        this->chunks.push_back(std::move(chunk));
+    }
+    char* memory = (char*)this->chunks[this->current].memory.get() + this->offset;
+    this->offset += size;
+    this->used += size;
+    this->total += size;
+    this->peak = std::max(this->peak, this->used);
+    if (this->isScratch) {
+        scratchTotal += size;
+        std::size_t previous = scratchPeak.load();
+        while (previous < this->used && !scratchPeak.compare_exchange_weak(previous, this->used)) {}
+    }
+    return memory;
+}
+
+PlanarImage::Buffer Arena::allocateFloats(std::size_t count) {
+    float* data = (float*)this->allocate(count * sizeof(float));
+    std::memset(data, 0, count * sizeof(float));
+    return PlanarImage::Buffer(data, keep);
+}
+
+Arena::Marker Arena::mark() const {
+    Marker marker;
+    marker.chunk = this->current;
+    marker.offset = this->offset;
+    marker.used = this->used;
+    return marker;
+}
+
+void Arena::rewind(const Marker& marker) {
+    this->current = marker.chunk;
+    this->offset = marker.offset;
+    this->used = marker.used;
+}
+
+void Arena::reset() {
+    this->rewind(Marker());
+    this->peak = 0;
+    this->total = 0;
+}
+
+void Arena::trim() {
+    const std::size_t keep = this->offset == 0 ? this->current : this->current + 1;
+    if (keep < this->chunks.size()) {
+        this->chunks.resize(keep);
+    }
+}
+
+std::size_t Arena::getPeakBytes() const {
+    return this->peak;
+}
+
+std::size_t Arena::getTotalBytes() const {
+    return this->total;
+}
+
+std::size_t Arena::getReservedBytes() const {
+    std::size_t bytes = 0;
+    for (const Chunk& chunk : this->chunks) {
+        bytes += chunk.bytes;
+    }
+    return bytes;
+}
+
+std::size_t Arena::getScratchPeakBytes() {
+    return scratchPeak.load();
+}
+
+std::size_t Arena::getScratchTotalBytes() {
+    return scratchTotal.load();
+}
+
+void Arena::resetScratchStatistics() {
+    scratchPeak = 0;
+    scratchTotal = 0;
+}
+
+ScratchLease::ScratchLease() : previous(lentArena) {
+    {
+        std::lock_guard<std::mutex> lock(leaseMutex);
+        if (!idleArenas.empty()) {
+            this->arena = idleArenas.back().release();
+            idleArenas.pop_back();
+        }
+        else {
+            this->arena = new Arena(scratchChunkBytes);
+            this->arena->isScratch = true;
+        }
+    }
+    lentArena = this->arena;
+}
+
+ScratchLease::~ScratchLease() {
+    lentArena = this->previous;
+    this->arena->rewind(Arena::Marker());
+    std::lock_guard<std::mutex> lock(leaseMutex);
+    idleArenas.emplace_back(this->arena);
+}
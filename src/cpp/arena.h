@@ -0,0 +1,151 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+// Include standard libraries
+#include <cstddef>
+#include <vector>
+// Include own classes
+#include "./planarImage.h"
+
+/**
+* \class Arena
+*
+* \brief A bump allocator for the transient buffers of a job.
+*
+* Memory is handed out from a few big 64 byte aligned chunks. Nothing is freed one by one: mark() and rewind()
+* return everything allocated after the mark at once and reset() returns everything. The chunks are kept, so a
+* long batch of jobs reuses the same memory instead of churning the heap. An Arena is not thread safe; workers
+* use their own scratch() arena.
+*
+* Buffers from an arena must not be used after the arena is rewound below them or reset.
+**/
+class Arena {
+public:
+    /// A position in the arena, see mark and rewind.
+    struct Marker {
+        std::size_t chunk = 0;
+        std::size_t offset = 0;
+        std::size_t used = 0;
+    };
+
+    /**
+    * \param std::size_t chunkBytes The size of a chunk. Bigger requests get a chunk of their own size.
+    **/
+    explicit Arena(std::size_t chunkBytes = 64u << 20);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+    * The arena of the calling thread for the temporaries of a kernel. Use it with an ArenaScope, so the memory
+    * is returned when the kernel is done. Its chunks live as long as the thread, or come from the pool of a
+    * ScratchLease the thread holds.
+    **/
+    static Arena& scratch();
+
+    /**
+    * Allocates uninitialized memory.
+    *
+    * \param std::size_t bytes The size, rounded up to 64 bytes
+    * \return 64 byte aligned memory
+    **/
+    void* allocate(std::size_t bytes);
+    /**
+    * Allocates 64 byte aligned floats, set to 0, in the layout of PlanarImage::allocate. The deleter of the
+    * buffer does nothing.
+    *
+    * \param std::size_t count The number of floats
+    **/
+    PlanarImage::Buffer allocateFloats(std::size_t count);
+
+    /// The current position.
+    Marker mark() const;
+    /// Returns everything allocated since the marker was taken.
+    void rewind(const Marker& marker);
+    /// Returns everything and starts new statistics, the chunks are kept.
+    void reset();
+    /// Frees the chunks after the current one, so the reserved memory shrinks to what is in use.
+    void trim();
+
+    /// The most memory in use at once since the last reset.
+    std::size_t getPeakBytes() const;
+    /// The sum of all allocations since the last reset.
+    std::size_t getTotalBytes() const;
+    /// The memory held by the chunks.
+    std::size_t getReservedBytes() const;
+
+    /// The highest peak of the scratch arenas of all threads since resetScratchStatistics.
+    static std::size_t getScratchPeakBytes();
+    /// The sum of all allocations of the scratch arenas of all threads since resetScratchStatistics.
+    static std::size_t getScratchTotalBytes();
+    /// Starts new statistics of the scratch arenas.
+    static void resetScratchStatistics();
+
+private:
+    struct Chunk {
+        PlanarImage::Buffer memory { nullptr, nullptr };
+        std::size_t bytes = 0;
+    };
+
+    /// The size of a new chunk.
+    std::size_t chunkBytes;
+    /// The chunks in order of use. The ones after the current chunk are free.
+    std::vector<Chunk> chunks;
+    /// The chunk allocations come from.
+    std::size_t current = 0;
+    /// The first free byte of the current chunk.
+    std::size_t offset = 0;
+    /// The bytes in use, including the ends of skipped chunks.
+    std::size_t used = 0;
+    /// See getPeakBytes.
+    std::size_t peak = 0;
+    /// See getTotalBytes.
+    std::size_t total = 0;
+    /// Whether this is a scratch arena, which also counts into the statistics of all scratch arenas.
+    bool isScratch = false;
+
+    friend class ScratchLease;
+};
+
+/**
+* \class ScratchLease
+*
+* Lends the calling thread a scratch arena from a pool of the process while it lives. Arena::scratch returns it
+* instead of the arena of the thread. The helper threads of parallel::forEach only live for one call, with arenas
+* of their own every call would allocate and free its chunks again.
+**/
+class ScratchLease {
+public:
+    ScratchLease();
+    /// Returns the arena to the pool, rewound but with its chunks.
+    ~ScratchLease();
+
+    ScratchLease(const ScratchLease&) = delete;
+    ScratchLease& operator=(const ScratchLease&) = delete;
+
+private:
+    /// The lent arena.
+    Arena* arena;
+    /// The arena lent before, for nested leases.
+    Arena* previous;
+};
+
+/**
+* \class ArenaScope
+*
+* Rewinds an arena to the position it had when the scope was entered.
+**/
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena) : arena(arena), marker(arena.mark()) {}
+    ~ArenaScope() { this->arena.rewind(this->marker); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena& arena;
+    Arena::Marker marker;
+};
+
+#endif // ARENA_H
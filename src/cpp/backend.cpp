@@ -0,0 +1,14 @@
+// Include own header
+#include "./backend.h"
+#include "./cpuBackend.h"
+#include "./glBackend.h"
+
+std::unique_ptr<Backend> Backend::create(const std::string& name, Report& report, Arena& arena) {
+    if (name == "gl") {
+        return std::unique_ptr<Backend>(new GLBackend(report, arena));
+    }
+    if (name == "cpu") {
+        return std::unique_ptr<Backend>(new CpuBackend(report, arena));
+    }
+    return std::unique_ptr<Backend>();
+}
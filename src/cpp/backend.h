@@ -0,0 +1,192 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+
+// Include standard libraries
+#include <memory>
+#include <string>
+#include <vector>
+// Include own classes
+#include "./arena.h"
+#include "./fastMath.h"
+#include "./report.h"
+
+/// The cube maps a Backend produces.
+enum class Product {
+    /// The equirectangular source converted to a cube.
+    Background,
+    /// The diffuse irradiance map.
+    Irradiance,
+    /// The specular prefiltered environment map, one roughness per mip level.
+    Prefiltered
+};
+
+/// How a Backend computes the irradiance map.
+enum class IrradianceMethod {
+    /// Integrates the hemisphere of every texel like diffuseIBL.frag.glsl.
+    Convolution,
+    /// Evaluates the spherical harmonics of the background, see shIrradiance.
+    SphericalHarmonics
+};
+
+/**
+* \class Backend
+*
+* \brief The engine which does the actual image processing for the Generator.
+*
+* The Generator only runs the pipeline and does the file IO. Every stage is handed to a Backend, so different
+* engines can be selected at runtime and be compared on the same jobs. All image data exchanged with a backend
+* is float RGB with the bottom row first, like OpenGL textures.
+**/
+class Backend {
+public:
+    virtual ~Backend() {}
+
+    /**
+    * Creates a backend by its name.
+    *
+    * \param std::string& name "gl" or "cpu"
+    * \param Report& report Receives the measurements of the backend
+    * \param Arena& arena Supplies the transient buffers of the jobs. Products are not taken from it.
+    * \return The backend or an empty pointer for unknown names.
+    **/
+    static std::unique_ptr<Backend> create(const std::string& name, Report& report, Arena& arena);
+
+    /// The name used to select the backend.
+    virtual std::string getName() const = 0;
+    /**
+    * Takes the equirectangular source image.
+    *
+    * \param const float* rgb The pixels, width * height * 3 floats
+    * \param unsigned int width The source width
+    * \param unsigned int height The source height
+    **/
+    virtual void uploadSource(const float* rgb, unsigned int width, unsigned int height) = 0;
+    /**
+    * Converts the source to the background cube including its mip chain. Prints an error and throws if there is no
+    * source, e.g. because it was released by an earlier base cube.
+    *
+    * \param unsigned int faceSize The side width of the cube
+    **/
+    virtual void makeBaseCube(unsigned int faceSize) = 0;
+    /**
+    * Convolves the background cube to the irradiance map.
+    *
+    * \param unsigned int faceSize The side width of the irradiance map
+    **/
+    virtual void makeIrradiance(unsigned int faceSize) = 0;
+    /**
+    * Prefilters the background cube with increasing roughness into the mip levels of a new cube.
+    *
+    * \param unsigned int levels The number of levels, the last one has roughness 1
+    * \param bool releaseBackground Frees the background cube as soon as the prefilter does not need it anymore,
+    * so it never coexists with the whole prefiltered cube if the backend can avoid it
+    **/
+    virtual void makePrefilteredChain(unsigned int levels, bool releaseBackground) = 0;
+    /**
+    * Replaces the background and prefiltered cubes by downsampled copies of at most half their size. The products
+    * are replaced one after the other, released ones are skipped.
+    *
+    * \param unsigned int faceSize The new side width
+    **/
+    virtual void downsampleProducts(unsigned int faceSize) = 0;
+    /**
+    * Frees a product which is not needed anymore. getSize returns 0 for it afterwards.
+    *
+    * \param Product product The product
+    **/
+    virtual void releaseProduct(Product product) = 0;
+    /// Blocks until all issued work is done, so timings are meaningful.
+    virtual void finish() {}
+    /// Adds the resources the backend holds outside of main memory to the report, if it has any.
+    virtual void reportResources() {}
+    /**
+    * Makes the calling thread the one running the stages, e.g. by making a context current on it. A backend is
+    * used by one thread at a time, the previous one has to call detachThread first. The creating thread is attached.
+    **/
+    virtual void attachThread() {}
+    /// Releases the calling thread, see attachThread.
+    virtual void detachThread() {}
+    /**
+    * The side width of a product level or 0 if it does not exist.
+    *
+    * \param Product product The product
+    * \param unsigned int level The mip level
+    **/
+    virtual unsigned int getSize(Product product, unsigned int level) const = 0;
+    /**
+    * Copies a face level of a product to main memory.
+    *
+    * \param Product product The product
+    * \param unsigned int face The face index
+    * \param unsigned int level The mip level
+    * \param float* rgb Destination for getSize(product, level)^2 * 3 floats
+    * \return false if the data is not available
+    **/
+    virtual bool readBackLevel(Product product, unsigned int face, unsigned int level, float* rgb) = 0;
+
+    /// The most probes makeProbeBatch takes at once, 0 if the backend has no batch mode, see ProbeBatch.
+    virtual unsigned int getMaxProbeBatch() const { return 0; }
+    /**
+    * Renders all products of several light probes at once, e.g. into array textures with a few draws instead of
+    * six per face set and probe. The products of the previous batch are replaced.
+    *
+    * \param const std::vector<const float*>& sources The equirectangular sources, float RGB with the bottom row first
+    * \param unsigned int width The width of every source
+    * \param unsigned int height The height of every source
+    * \param unsigned int faceSize The side width of the background and prefiltered cubes
+    * \param unsigned int irradianceSize The side width of the irradiance cubes
+    * \param unsigned int levels The prefiltered levels, see makePrefilteredChain
+    **/
+    virtual void makeProbeBatch(const std::vector<const float*>& /*sources*/, unsigned int /*width*/, unsigned int /*height*/,
+        unsigned int /*faceSize*/, unsigned int /*irradianceSize*/, unsigned int /*levels*/) {}
+    /**
+    * Copies a level of a product of every probe of the last batch to main memory in one go.
+    *
+    * \param Product product The product
+    * \param unsigned int level The mip level
+    * \param float* rgb Destination for probes * 6 faces of size^2 * 3 floats, the faces of a probe after each other
+    * \return false if the data is not available
+    **/
+    virtual bool readBackProbeLevel(Product /*product*/, unsigned int /*level*/, float* /*rgb*/) { return false; }
+    /// Gives up the products of the last batch.
+    virtual void releaseProbeBatch() {}
+
+    /// Build mip chains with cubeMipBuilder instead of a native generator, if the backend has one.
+    void setCpuMipmaps(bool enable) { this->cpuMipmaps = enable; }
+    /// The approximation of atan2 and asin for the direction to UV mapping, if the backend computes it itself.
+    void setMathPrecision(fastMath::Precision precision) { this->mathPrecision = precision; }
+    /// Give up caches and pooled memory as soon as a stage is done, trading speed for a lower peak.
+    void setLowMemory(bool enable) { this->lowMemory = enable; }
+    /// Also time the generic shader per prefiltered level to report the gain of the specialized ones, if the backend has them.
+    void setCompareShaderVariants(bool enable) { this->compareShaderVariants = enable; }
+    /// The GGX samples per prefiltered level, see sampleSchedule. Empty or missing levels use the full count.
+    void setSampleCounts(const std::vector<unsigned int>& counts) { this->sampleCounts = counts; }
+    /// How makeIrradiance computes the map.
+    void setIrradianceMethod(IrradianceMethod method) { this->irradianceMethod = method; }
+    /// Keep the source after the base cube, so makeBaseCube can run again, e.g. at another face size.
+    void setKeepSource(bool enable) { this->keepSource = enable; }
+
+protected:
+    Backend(Report& report, Arena& arena) : report(report), arena(arena) {}
+
+    /// Receives the measurements.
+    Report& report;
+    /// Supplies transient buffers. Everything taken from it is returned before a stage ends.
+    Arena& arena;
+    /// See setCpuMipmaps.
+    bool cpuMipmaps = false;
+    /// See setMathPrecision.
+    fastMath::Precision mathPrecision = fastMath::Precision::Exact;
+    /// See setLowMemory.
+    bool lowMemory = false;
+    /// See setCompareShaderVariants.
+    bool compareShaderVariants = false;
+    /// See setSampleCounts.
+    std::vector<unsigned int> sampleCounts;
+    /// See setIrradianceMethod.
+    IrradianceMethod irradianceMethod = IrradianceMethod::Convolution;
+    /// See setKeepSource.
+    bool keepSource = false;
+};
+
+#endif // BACKEND_H
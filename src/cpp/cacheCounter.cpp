@@ -0,0 +1,106 @@
+// Include own header
+#include "./cacheCounter.h"
+// Include standard libraries
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace {
+    /// Opens a disabled hardware counter of the calling process which is inherited by new threads.
+    int openCounter(unsigned long long config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    unsigned long long readCounter(int fd) {
+        unsigned long long value = 0;
+        if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value)) {
+            return 0;
+        }
+        return value;
+    }
+}
+#endif
+
+CacheCounter::CacheCounter() {
+#ifdef __linux__
+    this->missFd = openCounter(PERF_COUNT_HW_CACHE_MISSES);
+    this->referenceFd = openCounter(PERF_COUNT_HW_CACHE_REFERENCES);
+    if (this->missFd < 0 || this->referenceFd < 0) {
+        if (this->missFd >= 0) close(this->missFd);
+        if (this->referenceFd >= 0) close(this->referenceFd);
+        this->missFd = -1;
+        this->referenceFd = -1;
+    }
+#endif
+}
+
+CacheCounter::~CacheCounter() {
+#ifdef __linux__
+    if (this->isAvailable()) {
+        close(this->missFd);
+        close(this->referenceFd);
+    }
+#endif
+}
+
+void CacheCounter::start() {
+#ifdef __linux__
+    if (this->isAvailable()) {
+        for (int fd : { this->missFd, this->referenceFd }) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+void CacheCounter::stop() {
+#ifdef __linux__
+    if (this->isAvailable()) {
+        for (int fd : { this->missFd, this->referenceFd }) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        this->misses = readCounter(this->missFd);
+        this->references = readCounter(this->referenceFd);
+    }
+#endif
+}
+
+bool CacheCounter::isAvailable() const {
+    return this->missFd >= 0;
+}
+
+unsigned long long CacheCounter::getMisses() const {
+    return this->misses;
+}
+
+unsigned long long CacheCounter::getReferences() const {
+    return this->references;
+}
+
+std::string CacheCounter::describe(unsigned long long items, const std::string& unit) const {
+    if (!this->isAvailable()) {
+        return "unavailable";
+    }
+    std::ostringstream value;
+    value << this->misses << " of " << this->references << " references";
+    if (items > 0) {
+        value << ", " << std::fixed << std::setprecision(3) << double(this->misses) / items << " per " << unit;
+    }
+    return value.str();
+}
@@ -0,0 +1,51 @@
+#ifndef CACHECOUNTER_H
+#define CACHECOUNTER_H
+
+// Include standard libraries
+#include <string>
+
+/**
+* \class CacheCounter
+*
+* \brief Counts the last level cache references and misses of the process with the hardware performance counters.
+*
+* The counters include all threads started after start(), which covers parallel::forEach. They are read with the
+* perf events of Linux. On other platforms, or if the kernel does not allow access (perf_event_paranoid), the
+* counter is unavailable and describe() says so.
+**/
+class CacheCounter {
+public:
+    /// Opens the counters, they do not count until start().
+    CacheCounter();
+    /// Closes the counters.
+    ~CacheCounter();
+    CacheCounter(const CacheCounter&) = delete;
+    CacheCounter& operator=(const CacheCounter&) = delete;
+
+    /// Resets and starts counting.
+    void start();
+    /// Stops counting and reads the counts.
+    void stop();
+    /// Whether the platform provides the counts.
+    bool isAvailable() const;
+    /// The cache misses between start() and stop().
+    unsigned long long getMisses() const;
+    /// The cache references between start() and stop().
+    unsigned long long getReferences() const;
+    /**
+    * The counts in a form for a report.
+    *
+    * \param unsigned long long items The number of processed items, e.g. texels, to give the misses per item
+    * \param std::string& unit The name of an item
+    **/
+    std::string describe(unsigned long long items, const std::string& unit) const;
+
+private:
+    /// The perf event file descriptors, -1 if not available.
+    int missFd = -1;
+    int referenceFd = -1;
+    unsigned long long misses = 0;
+    unsigned long long references = 0;
+};
+
+#endif // CACHECOUNTER_H
@@ -5,6 +5,9 @@
 * It is a personal preference to store those in a seperate file.
 **/
 
+#ifndef CONSTANTS_H
+#define CONSTANTS_H
+
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
@@ -73,4 +76,6 @@ const float quadVertices[] = {
     -1.0f, -1.0f, 0.0f, 0.0f, 0.0f,
     1.0f,  1.0f, 0.0f, 1.0f, 1.0f,
     1.0f, -1.0f, 0.0f, 1.0f, 0.0f,
-};
\ No newline at end of file
+};
+
+#endif // CONSTANTS_H
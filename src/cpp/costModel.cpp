@@ -0,0 +1,97 @@
+// Include own header
+#include "./costModel.h"
+// Include standard libraries
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    /// The running average weights the last runs, so a changed machine or driver is picked up quickly.
+    const unsigned int averagedRuns = 4;
+}
+
+CostModel::CostModel(const std::string& fileName) : fileName(fileName) {
+    std::ifstream file(fileName);
+    std::string backend, stage;
+    Entry entry;
+    while (file >> backend >> stage >> entry.throughput >> entry.runs) {
+        if (entry.throughput > 0.0 && entry.runs > 0) {
+            this->entries[backend + " " + stage] = entry;
+        }
+    }
+}
+
+double CostModel::predictMs(const std::string& backend, Stage stage, double work) const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto found = this->entries.find(getKey(backend, stage));
+    const double throughput = found != this->entries.end() ? found->second.throughput : getDefaultThroughput(backend, stage);
+    return work / throughput;
+}
+
+bool CostModel::isCalibrated(const std::string& backend, Stage stage) const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->entries.count(getKey(backend, stage)) > 0;
+}
+
+void CostModel::record(const std::string& backend, Stage stage, double work, double ms) {
+    if (work <= 0.0 || ms <= 0.0) {
+        return;
+    }
+    const double throughput = work / ms;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto found = this->entries.find(getKey(backend, stage));
+    if (found == this->entries.end()) {
+        this->entries[getKey(backend, stage)] = { throughput, 1 };
+        return;
+    }
+    Entry& entry = found->second;
+    entry.runs = std::min(entry.runs + 1, averagedRuns);
+    entry.throughput += (throughput - entry.throughput) / entry.runs;
+}
+
+void CostModel::save() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::ofstream file(this->fileName, std::ios::trunc);
+    if (!file) {
+        std::cout << "ERROR: Cannot write the cost model: " << this->fileName << std::endl;
+        return;
+    }
+    for (const auto& entry : this->entries) {
+        file << entry.first << " " << entry.second.throughput << " " << entry.second.runs << "\n";
+    }
+}
+
+std::string CostModel::getKey(const std::string& backend, Stage stage) {
+    switch (stage) {
+    case Stage::BaseCube:
+        return backend + " base-cube";
+    case Stage::IrradianceConvolution:
+        return backend + " irradiance-convolution";
+    case Stage::IrradianceSH:
+        return backend + " irradiance-sh";
+    case Stage::Prefilter:
+        return backend + " prefilter";
+    case Stage::Save:
+        return backend + " save";
+    }
+    return backend;
+}
+
+double CostModel::getDefaultThroughput(const std::string& backend, Stage stage) {
+    // Rough figures of a single core and of a mid range GPU, the first measurement replaces them
+    const bool gpu = backend == "gl";
+    switch (stage) {
+    case Stage::BaseCube:
+        return gpu ? 200000.0 : 2000.0;
+    case Stage::IrradianceConvolution:
+        // 16000 samples per texel
+        return gpu ? 200.0 : 0.5;
+    case Stage::IrradianceSH:
+        return gpu ? 5000.0 : 6000.0;
+    case Stage::Prefilter:
+        return gpu ? 3000000.0 : 50000.0;
+    case Stage::Save:
+        return 20000.0;
+    }
+    return 1.0;
+}
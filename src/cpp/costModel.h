@@ -0,0 +1,82 @@
+#ifndef COSTMODEL_H
+#define COSTMODEL_H
+
+// Include standard libraries
+#include <map>
+#include <mutex>
+#include <string>
+
+/**
+* \class CostModel
+*
+* \brief Predicts the time of the pipeline stages from the throughput measured in previous runs.
+*
+* Every stage is modelled as work divided by the throughput of the backend for it: texels for the base cube, the
+* irradiance map and the saved files, texels x samples for the prefiltered chain. The Generator records the work and
+* the time of every stage it runs and the model keeps a running average per backend and stage, which is stored in a
+* small text file and loaded by the next run. Stages never measured on this machine use built in estimates.
+* Generators running in parallel can share one model, all methods are thread safe.
+**/
+class CostModel {
+public:
+    /// The modelled stages.
+    enum class Stage {
+        BaseCube,
+        IrradianceConvolution,
+        IrradianceSH,
+        Prefilter,
+        Save
+    };
+
+    /**
+    * Loads the throughputs of previous runs.
+    *
+    * \param const std::string& fileName The file, a missing one starts with the built in estimates
+    **/
+    explicit CostModel(const std::string& fileName);
+
+    /**
+    * The predicted time of a stage.
+    *
+    * \param const std::string& backend The name of the backend, see Backend::create
+    * \param Stage stage The stage
+    * \param double work The work units of the stage
+    **/
+    double predictMs(const std::string& backend, Stage stage, double work) const;
+    /// Whether the stage was measured on a previous run.
+    bool isCalibrated(const std::string& backend, Stage stage) const;
+    /**
+    * Adds a measurement to the running average of a stage.
+    *
+    * \param const std::string& backend The name of the backend
+    * \param Stage stage The stage
+    * \param double work The work units of the stage
+    * \param double ms The measured time
+    **/
+    void record(const std::string& backend, Stage stage, double work, double ms);
+    /// Writes the throughputs for the next run.
+    void save() const;
+
+private:
+    /// A stage of a backend.
+    struct Entry {
+        /// Work units per millisecond.
+        double throughput;
+        /// The number of measurements averaged, at most averagedRuns.
+        unsigned int runs;
+    };
+
+    /// See the constructor.
+    std::string fileName;
+    /// The measured stages by "backend stage".
+    std::map<std::string, Entry> entries;
+    /// Guards entries.
+    mutable std::mutex mutex;
+
+    /// The key of a stage in entries and in the file.
+    static std::string getKey(const std::string& backend, Stage stage);
+    /// The throughput of a stage which was never measured.
+    static double getDefaultThroughput(const std::string& backend, Stage stage);
+};
+
+#endif // COSTMODEL_H
@@ -0,0 +1,240 @@
+// Include own header
+#include "./cpuBackend.h"
+#include "./cacheCounter.h"
+#include "./cubeFaces.h"
+#include "./cubeMipBuilder.h"
+#include "./faceTables.h"
+#include "./fastMath.h"
+#include "./ggxPrefilter.h"
+#include "./parallel.h"
+#include "./shIrradiance.h"
+// Include standard libraries
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace {
+    const float PI = 3.14159265359f;
+    /// The side width of the blocks the base cube is rendered in.
+    const unsigned int blockSize = 32;
+
+    /// Resizes a face with bilinear filtering like a linear glBlitFramebuffer.
+    void resizeFace(const ConstImageView& src, const ImageView& dst) {
+        const unsigned int srcSize = src.width;
+        const unsigned int dstSize = dst.width;
+        const float scale = float(srcSize) / dstSize;
+        Arena& scratch = Arena::scratch();
+        const ArenaScope scope(scratch);
+        unsigned int* x0 = (unsigned int*)scratch.allocate(dstSize * sizeof(unsigned int));
+        unsigned int* x1 = (unsigned int*)scratch.allocate(dstSize * sizeof(unsigned int));
+        float* fx = (float*)scratch.allocate(dstSize * sizeof(float));
+        for (unsigned int x = 0; x < dstSize; ++x) {
+            const float px = std::min(std::max((x + 0.5f) * scale - 0.5f, 0.0f), float(srcSize - 1));
+            x0[x] = (unsigned int)px;
+            x1[x] = std::min(x0[x] + 1, srcSize - 1);
+            fx[x] = px - x0[x];
+        }
+        for (unsigned int c = 0; c < 3; ++c) {
+            for (unsigned int y = 0; y < dstSize; ++y) {
+                const float py = std::min(std::max((y + 0.5f) * scale - 0.5f, 0.0f), float(srcSize - 1));
+                const unsigned int y0 = (unsigned int)py;
+                const float fy = py - y0;
+                const float* row0 = src.row(c, y0);
+                const float* row1 = src.row(c, std::min(y0 + 1, srcSize - 1));
+                float* out = dst.row(c, y);
+                for (unsigned int x = 0; x < dstSize; ++x) {
+                    const float bottom = row0[x0[x]] * (1.0f - fx[x]) + row0[x1[x]] * fx[x];
+                    const float top = row1[x0[x]] * (1.0f - fx[x]) + row1[x1[x]] * fx[x];
+                    out[x] = bottom * (1.0f - fy) + top * fy;
+                }
+            }
+        }
+    }
+}
+
+CpuBackend::CpuBackend(Report& report, Arena& arena) : Backend(report, arena) {}
+
+std::string CpuBackend::getName() const {
+    return "cpu";
+}
+
+void CpuBackend::uploadSource(const float* rgb, unsigned int width, unsigned int height) {
+    Timer timer;
+    const ArenaScope scope(this->arena);
+    PlanarImage planes(width, height, &this->arena);
+    PlanarImage::deinterleave(rgb, planes.getView());
+    this->source.reset(new SourcePyramid(planes.getView(), this->arena));
+    this->report.addTiming("cpu source pyramid", timer.elapsedMs());
+    this->srcHeight = height;
+}
+
+void CpuBackend::makeBaseCube(unsigned int faceSize) {
+    if (!this->source || faceSize == 0) {
+        std::cout << "ERROR: No source uploaded for the base cube" << std::endl;
+        throw(2);
+    }
+    Timer timer;
+    this->background = CubeImage(faceSize, 0);
+    const std::shared_ptr<const FaceTables> tables = FaceTables::get(faceSize, this->report);
+    // Blocks of all faces from north to south, so the threads work on neighbouring source rows at the same time
+    std::vector<cubeFaces::Block> blocks;
+    for (unsigned int face = 0; face < 6; ++face) {
+        cubeFaces::Block area = { face, 0, 0, faceSize, faceSize, 0.0f };
+        cubeFaces::splitIntoBlocks(faceSize, area, blockSize, blocks);
+    }
+    cubeFaces::sortByLatitude(blocks);
+    CacheCounter cacheCounter;
+    cacheCounter.start();
+    parallel::forEach((unsigned int)blocks.size(), [&](unsigned int item) {
+        const cubeFaces::Block& block = blocks[item];
+        const float* dirX = tables->getX(block.face);
+        const float* dirY = tables->getY(block.face);
+        const float* dirZ = tables->getZ(block.face);
+        const ImageView texels = this->background.getFace(0, block.face);
+        float u[blockSize], v[blockSize];
+        for (unsigned int y = block.y0; y < block.y0 + block.height; ++y) {
+            const std::size_t first = std::size_t(y) * faceSize + block.x0;
+            fastMath::directionsToUv(dirX + first, dirY + first, dirZ + first, block.width, u, v, this->mathPrecision);
+            for (unsigned int x = block.x0; x < block.x0 + block.width; ++x) {
+                const std::size_t i = std::size_t(y) * faceSize + x;
+                const glm::vec3 dir(dirX[i], dirY[i], dirZ[i]);
+                // Same LOD as equiToCube.frag.glsl. With p = dir / maxAxis on the unit cube dot(p, p)^-0.75 = maxAxis^1.5.
+                const float maxAxis = std::max(std::max(std::abs(dir.x), std::abs(dir.y)), std::abs(dir.z));
+                const float texelAngle = 2.0f / faceSize * std::pow(maxAxis, 1.5f);
+                const float lod = std::max(std::log2(texelAngle * this->srcHeight / PI), 0.0f);
+                float rgb[3];
+                this->source->sample(u[x - block.x0], v[x - block.x0], lod, rgb);
+                for (unsigned int c = 0; c < 3; ++c) {
+                    texels.at(c, x, y) = rgb[c];
+                }
+            }
+        }
+    });
+    cacheCounter.stop();
+    const double ms = timer.elapsedMs();
+    const unsigned long long texelCount = 6ull * faceSize * faceSize;
+    std::ostringstream throughput;
+    throughput << std::fixed << std::setprecision(1) << texelCount / (ms * 1000.0) << " Mtexels/s";
+    this->report.addValue("cpu base cube throughput", throughput.str() + ", " + fastMath::getName(this->mathPrecision) + " math");
+    this->report.addValue("cpu base cube cache misses", cacheCounter.describe(texelCount, "texel"));
+    // Nothing samples the source after the base cube
+    if (!this->keepSource) {
+        this->source.reset();
+    }
+    cubeMipBuilder::build(this->background, this->report, this->arena);
+}
+
+void CpuBackend::makeIrradiance(unsigned int faceSize) {
+    this->irradiance = CubeImage(faceSize, 1);
+    if (this->irradianceMethod == IrradianceMethod::SphericalHarmonics) {
+        const unsigned int level = shIrradiance::projectionLevel(this->background.getSize());
+        shIrradiance::evaluate(shIrradiance::project(this->background, level, this->report), this->irradiance, this->report);
+        return;
+    }
+    const std::shared_ptr<const FaceTables> tables = FaceTables::get(faceSize, this->report);
+    // The shader relies on the implicit LOD of texture(), which is the footprint of an irradiance texel
+    const float lod = std::log2(float(this->background.getSize()) / faceSize);
+    const float sampleDelta = 0.025f;
+    parallel::forEach(6 * faceSize, [&](unsigned int item) {
+        const unsigned int face = item / faceSize;
+        const unsigned int y = item % faceSize;
+        const ImageView texels = this->irradiance.getFace(0, face);
+        for (unsigned int x = 0; x < faceSize; ++x) {
+            const std::size_t i = std::size_t(y) * faceSize + x;
+            const glm::vec3 normal(tables->getX(face)[i], tables->getY(face)[i], tables->getZ(face)[i]);
+            glm::vec3 up(0.0f, 1.0f, 0.0f);
+            const glm::vec3 right = glm::cross(up, normal);
+            up = glm::cross(normal, right);
+            float sum[3] = { 0.0f, 0.0f, 0.0f };
+            float nrSamples = 0.0f;
+            for (float phi = 0.0f; phi < 2.0f * PI; phi += sampleDelta) {
+                for (float theta = 0.0f; theta < 0.5f * PI; theta += sampleDelta) {
+                    const glm::vec3 tangentSample(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+                    const glm::vec3 sampleVec = tangentSample.x * right + tangentSample.y * up + tangentSample.z * normal;
+                    float color[3];
+                    this->background.sample(sampleVec, lod, color);
+                    const float weight = std::cos(theta) * std::sin(theta);
+                    for (int c = 0; c < 3; ++c) {
+                        sum[c] += color[c] * weight;
+                    }
+                    nrSamples++;
+                }
+            }
+            for (int c = 0; c < 3; ++c) {
+                texels.at(c, x, y) = PI * sum[c] / nrSamples;
+            }
+        }
+    });
+}
+
+void CpuBackend::makePrefilteredChain(unsigned int levels, bool releaseBackground) {
+    this->prefiltered = CubeImage();
+    this->prefiltered = ggxPrefilter::prefilter(this->background, levels, this->sampleCounts, releaseBackground, this->scheduler, this->report, this->arena);
+    this->report.addValue("face tables cached", Report::formatBytes(FaceTables::getCachedBytes()));
+}
+
+void CpuBackend::downsampleProducts(unsigned int faceSize) {
+    // One product after the other, so only one of them exists twice at a time
+    if (this->background.getLevelCount() > 0) {
+        CubeImage background(faceSize, 0);
+        parallel::forEach(6, [&](unsigned int face) {
+            resizeFace(this->background.getFace(0, face), background.getFace(0, face));
+        });
+        this->background = CubeImage();
+        cubeMipBuilder::build(background, this->report, this->arena);
+        this->background = std::move(background);
+    }
+    if (this->prefiltered.getLevelCount() > 0) {
+        CubeImage prefiltered(faceSize, this->prefiltered.getLevelCount());
+        parallel::forEach(6, [&](unsigned int face) {
+            // Every prefiltered level keeps its roughness, only its resolution shrinks
+            for (unsigned int mip = 0; mip < prefiltered.getLevelCount(); ++mip) {
+                resizeFace(this->prefiltered.getFace(mip, face), prefiltered.getFace(mip, face));
+            }
+        });
+        this->prefiltered = std::move(prefiltered);
+    }
+}
+
+void CpuBackend::releaseProduct(Product product) {
+    this->getCube(product) = CubeImage();
+}
+
+CubeImage& CpuBackend::getCube(Product product) {
+    switch (product) {
+    case Product::Background:
+        return this->background;
+    case Product::Irradiance:
+        return this->irradiance;
+    default:
+        return this->prefiltered;
+    }
+}
+
+const CubeImage& CpuBackend::getCube(Product product) const {
+    switch (product) {
+    case Product::Background:
+        return this->background;
+    case Product::Irradiance:
+        return this->irradiance;
+    default:
+        return this->prefiltered;
+    }
+}
+
+unsigned int CpuBackend::getSize(Product product, unsigned int level) const {
+    const CubeImage& cube = this->getCube(product);
+    return level < cube.getLevelCount() ? cube.getSize(level) : 0;
+}
+
+bool CpuBackend::readBackLevel(Product product, unsigned int face, unsigned int level, float* rgb) {
+    const CubeImage& cube = this->getCube(product);
+    if (level >= cube.getLevelCount()) {
+        return false;
+    }
+    PlanarImage::interleave(cube.getFace(level, face), rgb);
+    return true;
+}
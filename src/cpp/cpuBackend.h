@@ -0,0 +1,59 @@
+#ifndef CPUBACKEND_H
+#define CPUBACKEND_H
+
+// Include standard libraries
+#include <memory>
+// Include own classes
+#include "./backend.h"
+#include "./cubeImage.h"
+#include "./sourcePyramid.h"
+#include "./taskScheduler.h"
+
+/**
+* \class CpuBackend
+*
+* \brief Computes all products on the CPU without any OpenGL context.
+*
+* The stages are ports of the shaders equiToCube, diffuseIBL and prefilterEnvIBL (see ggxPrefilter). Lookups behave
+* like the textures of the OpenGL backend: the source is sampled from a SourcePyramid, the cubes are sampled trilinear
+* and seamless. Texels are spread over all cores with parallel::forEach.
+**/
+class CpuBackend : public Backend {
+public:
+    /**
+    * \param Report& report Receives the measurements of the backend
+    * \param Arena& arena Supplies the transient buffers of the jobs
+    **/
+    CpuBackend(Report& report, Arena& arena);
+
+    std::string getName() const override;
+    void uploadSource(const float* rgb, unsigned int width, unsigned int height) override;
+    void makeBaseCube(unsigned int faceSize) override;
+    void makeIrradiance(unsigned int faceSize) override;
+    void makePrefilteredChain(unsigned int levels, bool releaseBackground) override;
+    void downsampleProducts(unsigned int faceSize) override;
+    void releaseProduct(Product product) override;
+    unsigned int getSize(Product product, unsigned int level) const override;
+    bool readBackLevel(Product product, unsigned int face, unsigned int level, float* rgb) override;
+
+private:
+    /// The height of the equirectangular source.
+    unsigned int srcHeight = 0;
+    /// The latitude aware mip chain of the source.
+    std::unique_ptr<SourcePyramid> source;
+    /// The background cube with its complete mip chain.
+    CubeImage background;
+    /// The irradiance map without mip chain.
+    CubeImage irradiance;
+    /// One roughness per level.
+    CubeImage prefiltered;
+    /// Balances the prefilter tiles over all cores.
+    TaskScheduler scheduler;
+
+    /// The cube of a product.
+    const CubeImage& getCube(Product product) const;
+    /// The cube of a product.
+    CubeImage& getCube(Product product);
+};
+
+#endif // CPUBACKEND_H
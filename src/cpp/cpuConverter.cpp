@@ -0,0 +1,458 @@
+// Include own header
+#include "./cpuConverter.h"
+#include "./cacheCounter.h"
+#include "./cubeFaces.h"
+#include "./cubeImage.h"
+#include "./hdrio.h"
+#include "./memoryStats.h"
+#include "./sourcePyramid.h"
+// Include standard libraries
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+// Include glm for vector and matrix operations
+#include "glm/glm.hpp"
+
+namespace {
+    const float PI = 3.14159265359f;
+    /// The side width of the blocks a tile is rendered in.
+    const unsigned int blockSize = 32;
+
+    /// Seeks in files bigger than 2GB.
+    int seek64(std::FILE* file, unsigned long long offset) {
+#ifdef _WIN32
+        return _fseeki64(file, (long long)offset, SEEK_SET);
+#else
+        return fseeko(file, (off_t)offset, SEEK_SET);
+#endif
+    }
+}
+
+CpuConverter::CpuConverter(const std::string& in) {
+    this->inFilePath = in;
+    HdrReader reader(in);
+    this->srcWidth = reader.getWidth();
+    this->srcHeight = reader.getHeight();
+    this->faceSize = this->srcWidth / 4;
+}
+
+void CpuConverter::setFaceSize(unsigned int size) {
+    this->faceSize = size != 0 ? size : this->srcWidth / 4;
+}
+
+void CpuConverter::setMemoryBudget(std::size_t bytes) {
+    this->memoryBudget = bytes;
+}
+
+void CpuConverter::setMathPrecision(fastMath::Precision precision) {
+    this->mathPrecision = precision;
+}
+
+void CpuConverter::faceToSource(unsigned int face, float x, float y, float &srcX, float &srcY) const {
+    this->rowToSource(face, x, 1, y, &srcX, &srcY);
+}
+
+void CpuConverter::rowToSource(unsigned int face, float x, unsigned int count, float y, float* srcX, float* srcY) const {
+    float dirX[blockSize], dirY[blockSize], dirZ[blockSize], u[blockSize], v[blockSize];
+    const float ny = 2.0f * y / this->faceSize - 1.0f;
+    for (unsigned int first = 0; first < count; first += blockSize) {
+        const unsigned int n = std::min(count - first, blockSize);
+        for (unsigned int i = 0; i < n; ++i) {
+            const float nx = 2.0f * (x + first + i) / this->faceSize - 1.0f;
+            const glm::vec3 dir = glm::normalize(cubeFaces::direction(face, nx, ny));
+            dirX[i] = dir.x;
+            dirY[i] = dir.y;
+            dirZ[i] = dir.z;
+        }
+        // Same mapping as SampleSphericalMap in equiToCube.frag.glsl. The source rows are counted from the top.
+        fastMath::directionsToUv(dirX, dirY, dirZ, n, u, v, this->mathPrecision);
+        for (unsigned int i = 0; i < n; ++i) {
+            srcX[first + i] = u[i] * this->srcWidth - 0.5f;
+            srcY[first + i] = (1.0f - v[i]) * this->srcHeight - 0.5f;
+        }
+    }
+}
+
+void CpuConverter::planLevels() {
+    // Only the levels the face size samples, see GLBackend::uploadSourceLevels
+    unsigned int fullLevels = 1;
+    for (unsigned int w = this->srcWidth, h = this->srcHeight; w > 1 || h > 1; w = std::max(w / 2, 1u), h = std::max(h / 2, 1u)) {
+        ++fullLevels;
+    }
+    const double maxLod = std::log2(2.0 * this->srcHeight / (PI * this->faceSize));
+    const unsigned int levels = std::min(maxLod > 0.0 ? (unsigned int)std::ceil(maxLod) + 1 : 1u, fullLevels);
+    this->levelWidths.assign(1, this->srcWidth);
+    this->levelHeights.assign(1, this->srcHeight);
+    this->rowEnds.assign(1, std::vector<unsigned int>(this->srcHeight));
+    for (unsigned int row = 0; row < this->srcHeight; ++row) {
+        this->rowEnds[0][row] = row;
+    }
+    for (unsigned int level = 1; level < levels; ++level) {
+        const unsigned int height = this->levelHeights[level - 1];
+        // The 2x2 reduction of SourcePyramid, a level one row high reduces its row with itself. The pyramid starts
+        // at the bottom row like OpenGL textures, so an odd height drops the top row of the level.
+        const unsigned int stepY = height > 1 ? 2 : 1;
+        const unsigned int skipped = height > 1 ? height % 2 : 0;
+        this->levelWidths.push_back(std::max(this->levelWidths[level - 1] / 2, 1u));
+        this->levelHeights.push_back(std::max(height / 2, 1u));
+        std::vector<unsigned int> ends(this->levelHeights[level]);
+        for (unsigned int row = 0; row < ends.size(); ++row) {
+            ends[row] = this->rowEnds[level - 1][skipped + row * stepY + stepY - 1];
+        }
+        this->rowEnds.push_back(std::move(ends));
+    }
+}
+
+float CpuConverter::lodAt(float distance2) const {
+    // Same LOD as CpuBackend::makeBaseCube with maxAxis = 1 / sqrt(1 + distance2) for the unnormalized direction
+    const float maxAxis = 1.0f / std::sqrt(1.0f + distance2);
+    const float texelAngle = 2.0f / this->faceSize * std::pow(maxAxis, 1.5f);
+    const float lod = std::log2(texelAngle * this->srcHeight / PI);
+    return glm::clamp(lod, 0.0f, float(this->levelWidths.size() - 1));
+}
+
+std::vector<CpuConverter::Tile> CpuConverter::planTiles(unsigned int tileSize, std::vector<unsigned int> &windowRows) const {
+    std::vector<Tile> tiles;
+    const unsigned int levels = (unsigned int)this->levelWidths.size();
+    const float maxRow = float(this->srcHeight - 1);
+    for (unsigned int face = 0; face < 6; ++face) {
+        for (unsigned int y0 = 0; y0 < this->faceSize; y0 += tileSize) {
+            for (unsigned int x0 = 0; x0 < this->faceSize; x0 += tileSize) {
+                Tile tile;
+                tile.face = face;
+                tile.x0 = x0;
+                tile.y0 = y0;
+                tile.width = std::min(tileSize, this->faceSize - x0);
+                tile.height = std::min(tileSize, this->faceSize - y0);
+                const unsigned int x1 = x0 + tile.width - 1;
+                const unsigned int y1 = y0 + tile.height - 1;
+                // The latitude has no extremum inside a tile except at a pole, so the border texels are enough
+                float minY = maxRow;
+                float maxY = 0.0f;
+                float srcX, srcY;
+                for (unsigned int i = x0; i <= x1; ++i) {
+                    for (unsigned int j : { y0, y1 }) {
+                        this->faceToSource(face, i + 0.5f, j + 0.5f, srcX, srcY);
+                        minY = std::min(minY, srcY);
+                        maxY = std::max(maxY, srcY);
+                    }
+                }
+                for (unsigned int j = y0; j <= y1; ++j) {
+                    for (unsigned int i : { x0, x1 }) {
+                        this->faceToSource(face, i + 0.5f, j + 0.5f, srcX, srcY);
+                        minY = std::min(minY, srcY);
+                        maxY = std::max(maxY, srcY);
+                    }
+                }
+                const float center = this->faceSize * 0.5f;
+                if ((face == 2 || face == 3) && x0 <= center && center <= x1 + 1 && y0 <= center && center <= y1 + 1) {
+                    if (face == 2) minY = 0.0f; else maxY = maxRow;
+                }
+                minY = glm::clamp(minY, 0.0f, maxRow);
+                maxY = glm::clamp(maxY, 0.0f, maxRow);
+
+                // The LOD grows towards the face center, so the nearest and the farthest texel bound it
+                const float nx0 = 2.0f * (x0 + 0.5f) / this->faceSize - 1.0f;
+                const float nx1 = 2.0f * (x1 + 0.5f) / this->faceSize - 1.0f;
+                const float ny0 = 2.0f * (y0 + 0.5f) / this->faceSize - 1.0f;
+                const float ny1 = 2.0f * (y1 + 0.5f) / this->faceSize - 1.0f;
+                const float nearX = glm::clamp(0.0f, nx0, nx1);
+                const float nearY = glm::clamp(0.0f, ny0, ny1);
+                const float farX = std::max(std::abs(nx0), std::abs(nx1));
+                const float farY = std::max(std::abs(ny0), std::abs(ny1));
+                tile.firstLevel = (unsigned int)this->lodAt(farX * farX + farY * farY);
+                tile.lastLevel = std::min((unsigned int)this->lodAt(nearX * nearX + nearY * nearY) + 1, levels - 1);
+
+                tile.firstRows.assign(levels, 0);
+                tile.lastRows.assign(levels, 0);
+                tile.readyRow = 0;
+                for (unsigned int level = tile.firstLevel; level <= tile.lastLevel; ++level) {
+                    const float height = float(this->levelHeights[level]);
+                    const float scale = height / this->srcHeight;
+                    const float first = glm::clamp((minY + 0.5f) * scale - 0.5f, 0.0f, height - 1.0f);
+                    const float last = glm::clamp((maxY + 0.5f) * scale - 0.5f, 0.0f, height - 1.0f);
+                    tile.firstRows[level] = (unsigned int)first;
+                    tile.lastRows[level] = std::min((unsigned int)last + 1, this->levelHeights[level] - 1);
+                    tile.readyRow = std::max(tile.readyRow, this->rowEnds[level][tile.lastRows[level]]);
+                }
+                tiles.push_back(tile);
+            }
+        }
+    }
+    std::sort(tiles.begin(), tiles.end(), [](const Tile& a, const Tile& b) { return a.readyRow < b.readyRow; });
+
+    // A row of a level stays resident as long as a tile which starts at or before it is pending. The rows which
+    // arrive until a tile is rendered overwrite the oldest ones, so the ring has to reach back to its first row.
+    windowRows.assign(levels, 0);
+    for (const Tile& tile : tiles) {
+        for (unsigned int level = tile.firstLevel; level <= tile.lastLevel; ++level) {
+            const std::vector<unsigned int>& ends = this->rowEnds[level];
+            const unsigned int available = (unsigned int)(std::upper_bound(ends.begin(), ends.end(), tile.readyRow) - ends.begin());
+            windowRows[level] = std::max(windowRows[level], available - tile.firstRows[level]);
+        }
+    }
+    return tiles;
+}
+
+void CpuConverter::renderTile(const Tile& tile, const std::vector<ConstImageView>& windows, const ImageView& out) const {
+    // Bilinear lookup in a level, wrapping around horizontally. Clamping to the rows of the tile keeps rounding
+    // differences between the batch and the single lookups of planTiles inside the resident window.
+    auto sampleLevel = [&](unsigned int level, float srcX, float srcY, float* rgb) {
+        const ConstImageView& window = windows[level];
+        const unsigned int width = this->levelWidths[level];
+        const float px = (srcX + 0.5f) * width / this->srcWidth - 0.5f;
+        const float py = glm::clamp((srcY + 0.5f) * this->levelHeights[level] / this->srcHeight - 0.5f,
+            float(tile.firstRows[level]), float(tile.lastRows[level]));
+        const float fx = std::floor(px);
+        const float tx = px - fx;
+        const unsigned int row0 = (unsigned int)py;
+        const unsigned int row1 = std::min(row0 + 1, tile.lastRows[level]);
+        const float ty = py - row0;
+        const int ix = int(fx) % int(width);
+        const unsigned int col0 = ix < 0 ? ix + width : ix;
+        const unsigned int col1 = col0 + 1 == width ? 0 : col0 + 1;
+        for (unsigned int c = 0; c < 3; ++c) {
+            const float* r0 = window.row(c, row0 % window.height);
+            const float* r1 = window.row(c, row1 % window.height);
+            const float top = r0[col0] + (r0[col1] - r0[col0]) * tx;
+            const float bottom = r1[col0] + (r1[col1] - r1[col0]) * tx;
+            rgb[c] = top + (bottom - top) * ty;
+        }
+    };
+    // A face row crosses many source rows, especially on +-Y. Blocks in latitude order keep the few source rows a
+    // block reads in the cache until the next block needs them.
+    std::vector<cubeFaces::Block> blocks;
+    cubeFaces::Block area = { tile.face, tile.x0, tile.y0, tile.width, tile.height, 0.0f };
+    cubeFaces::splitIntoBlocks(this->faceSize, area, blockSize, blocks);
+    cubeFaces::sortByLatitude(blocks);
+    float rowX[blockSize], rowY[blockSize];
+    for (const cubeFaces::Block& block : blocks) {
+        for (unsigned int y = block.y0; y < block.y0 + block.height; ++y) {
+            this->rowToSource(tile.face, block.x0 + 0.5f, block.width, y + 0.5f, rowX, rowY);
+            const float ny = 2.0f * (y + 0.5f) / this->faceSize - 1.0f;
+            for (unsigned int x = block.x0; x < block.x0 + block.width; ++x) {
+                const float nx = 2.0f * (x + 0.5f) / this->faceSize - 1.0f;
+                const float lod = glm::clamp(this->lodAt(nx * nx + ny * ny), float(tile.firstLevel), float(tile.lastLevel));
+                const unsigned int level = (unsigned int)lod;
+                const float t = lod - level;
+                float rgb[3];
+                sampleLevel(level, rowX[x - block.x0], rowY[x - block.x0], rgb);
+                if (t > 0.0f && level < tile.lastLevel) {
+                    float next[3];
+                    sampleLevel(level + 1, rowX[x - block.x0], rowY[x - block.x0], next);
+                    for (unsigned int c = 0; c < 3; ++c) {
+                        rgb[c] += (next[c] - rgb[c]) * t;
+                    }
+                }
+                for (unsigned int c = 0; c < 3; ++c) {
+                    out.at(c, x - tile.x0, y - tile.y0) = rgb[c];
+                }
+            }
+        }
+    }
+}
+
+void CpuConverter::convert(const std::string& outBaseName, Report& report) {
+    Timer timer;
+    const std::size_t srcRowBytes = std::size_t(this->srcWidth) * 3 * sizeof(float);
+    const std::size_t faceBytes = PlanarImage::bytesFor(this->faceSize, this->faceSize);
+
+    // Find the biggest tile size whose windows fit into the budget
+    this->planLevels();
+    const unsigned int levels = (unsigned int)this->levelWidths.size();
+    unsigned int tileSize = std::min(256u, this->faceSize);
+    std::vector<unsigned int> windowRows;
+    std::vector<Tile> tiles;
+    std::size_t windowBytes = 0;
+    unsigned int residentRows = 0;
+    std::size_t resident = 0;
+    while (true) {
+        tiles = this->planTiles(tileSize, windowRows);
+        windowBytes = 0;
+        residentRows = 0;
+        std::size_t rowBytes = 0;
+        for (unsigned int level = 0; level < levels; ++level) {
+            windowBytes += PlanarImage::bytesFor(this->levelWidths[level], windowRows[level]);
+            residentRows += windowRows[level];
+            // Two unfiltered rows per level for the reduction into the next one
+            rowBytes += PlanarImage::bytesFor(this->levelWidths[level], 2);
+        }
+        resident = windowBytes + rowBytes + PlanarImage::bytesFor(tileSize, tileSize) +
+            std::size_t(this->srcWidth) * 4 + srcRowBytes + std::size_t(this->faceSize) * 3 * sizeof(float);
+        if (this->memoryBudget == 0 || resident <= this->memoryBudget) {
+            break;
+        }
+        if (tileSize <= 8) {
+            std::cout << "ERROR: Memory budget of " << Report::formatBytes(this->memoryBudget)
+                << " is too small. At least " << Report::formatBytes(resident) << " are needed." << std::endl;
+            throw(3);
+        }
+        tileSize /= 2;
+    }
+    // Keep the faces in memory if they fit, otherwise stream finished tiles to scratch files
+    const bool facesInMemory = this->memoryBudget == 0 || resident + 6 * faceBytes <= this->memoryBudget;
+    CubeImage faces;
+    if (facesInMemory) {
+        faces = CubeImage(this->faceSize, 1);
+    }
+    std::FILE* scratch[6] = {};
+    // Closes and deletes the scratch files which are still open, before the conversion fails or after the output
+    auto removeScratch = [&]() {
+        for (unsigned int face = 0; face < 6; ++face) {
+            if (scratch[face] != nullptr) {
+                std::fclose(scratch[face]);
+                scratch[face] = nullptr;
+                std::remove((outBaseName + "_" + std::to_string(face) + ".tmp").c_str());
+            }
+        }
+    };
+    for (unsigned int face = 0; face < 6; ++face) {
+        if (!facesInMemory) {
+            const std::string scratchPath = outBaseName + "_" + std::to_string(face) + ".tmp";
+            scratch[face] = std::fopen(scratchPath.c_str(), "w+b");
+            if (scratch[face] == nullptr) {
+                std::cout << "ERROR: Could not create scratch file: " << scratchPath << std::endl;
+                removeScratch();
+                throw(1);
+            }
+        }
+    }
+    report.addTiming("tile planning", timer.elapsedMs());
+
+    timer.restart();
+    CacheCounter cacheCounter;
+    cacheCounter.start();
+    HdrReader reader(this->inFilePath);
+    // Per level the ring of filtered rows the tiles read and the last two unfiltered rows for the reduction
+    std::vector<PlanarImage> windows;
+    std::vector<PlanarImage> isoRows;
+    std::vector<ConstImageView> windowViews;
+    std::vector<unsigned int> producedRows(levels, 0);
+    for (unsigned int level = 0; level < levels; ++level) {
+        windows.emplace_back(this->levelWidths[level], windowRows[level]);
+        isoRows.emplace_back(this->levelWidths[level], 2);
+        windowViews.push_back(windows.back().getView());
+    }
+    auto rowOf = [](const ImageView& view, unsigned int y) {
+        return ImageView(view.row(0, y), view.width, 1, view.stride, view.planeStride);
+    };
+    PlanarImage tileImage(tileSize, tileSize);
+    std::vector<float> scanline(std::size_t(this->srcWidth) * 3);
+    std::vector<float> rowBuffer(std::size_t(this->faceSize) * 3);
+    std::size_t next = 0;
+    for (unsigned int row = 0; row < this->srcHeight; ++row) {
+        if (!reader.readScanline(scanline.data())) {
+            std::cout << "ERROR: Image load error!" << std::endl;
+            removeScratch();
+            throw(2);
+        }
+        PlanarImage::deinterleave(scanline.data(), rowOf(isoRows[0].getView(), row % 2));
+        // Filter the new row into its level and reduce it into the next level once its pair is complete
+        for (unsigned int level = 0; level < levels; ++level) {
+            const unsigned int y = producedRows[level]++;
+            const ImageView iso = isoRows[level].getView();
+            if (windowRows[level] > 0) {
+                SourcePyramid::filterRow(rowOf(iso, y % 2), rowOf(windows[level].getView(), y % windowRows[level]), y, this->levelHeights[level]);
+            }
+            if (level + 1 == levels) {
+                break;
+            }
+            // Pairs start below the dropped top row of an odd level, see planLevels
+            const unsigned int height = this->levelHeights[level];
+            const unsigned int skipped = height > 1 ? height % 2 : 0;
+            const ImageView nextRow = rowOf(isoRows[level + 1].getView(), producedRows[level + 1] % 2);
+            if (height == 1) {
+                SourcePyramid::reduceRows(rowOf(iso, 0), rowOf(iso, 0), nextRow);
+            }
+            else if (y > skipped && (y - skipped) % 2 == 1) {
+                SourcePyramid::reduceRows(rowOf(iso, (y - 1) % 2), rowOf(iso, y % 2), nextRow);
+            }
+            else {
+                break;
+            }
+        }
+        // Render every tile that got its last row
+        for (; next < tiles.size() && tiles[next].readyRow == row; ++next) {
+            const Tile& tile = tiles[next];
+            const ImageView tileView = tileImage.getView();
+            const ImageView out(tileView.data, tile.width, tile.height, tileView.stride, tileView.planeStride);
+            this->renderTile(tile, windowViews, out);
+            for (unsigned int j = 0; j < tile.height; ++j) {
+                if (facesInMemory) {
+                    const ImageView face = faces.getFace(0, tile.face);
+                    for (unsigned int c = 0; c < 3; ++c) {
+                        std::copy(out.row(c, j), out.row(c, j) + tile.width, face.row(c, tile.y0 + j) + tile.x0);
+                    }
+                }
+                else {
+                    // The scratch files hold interleaved rows like the output
+                    PlanarImage::interleave(ConstImageView(out.row(0, j), tile.width, 1, out.stride, out.planeStride), rowBuffer.data());
+                    if (seek64(scratch[tile.face], (std::size_t(tile.y0 + j) * this->faceSize + tile.x0) * 3 * sizeof(float)) != 0 ||
+                        std::fwrite(rowBuffer.data(), sizeof(float), tile.width * 3, scratch[tile.face]) != tile.width * 3) {
+                        std::cout << "ERROR: Could not write scratch file: " << outBaseName << "_" << tile.face << ".tmp" << std::endl;
+                        removeScratch();
+                        throw(1);
+                    }
+                }
+            }
+        }
+    }
+    cacheCounter.stop();
+    const double streamedMs = timer.elapsedMs();
+    windows.clear();
+    isoRows.clear();
+    report.addTiming("streamed conversion", streamedMs);
+    const unsigned long long texels = 6ull * this->faceSize * this->faceSize;
+    std::ostringstream throughput;
+    throughput << std::fixed << std::setprecision(1) << texels / (streamedMs * 1000.0) << " Mtexels/s";
+    report.addValue("streamed conversion throughput", throughput.str());
+    report.addValue("streamed conversion cache misses", cacheCounter.describe(texels, "texel"));
+
+    // Write the faces top row first, the face buffers start with the bottom row like OpenGL textures
+    timer.restart();
+    for (unsigned int face = 0; face < 6; ++face) {
+        HdrWriter writer(outBaseName + "_" + std::to_string(face) + ".hdr", this->faceSize, this->faceSize);
+        for (unsigned int row = this->faceSize; row-- > 0;) {
+            if (facesInMemory) {
+                const ImageView view = faces.getFace(0, face);
+                PlanarImage::interleave(ConstImageView(view.row(0, row), this->faceSize, 1, view.stride, view.planeStride), rowBuffer.data());
+                writer.writeScanline(rowBuffer.data());
+            }
+            else {
+                // A short read would leave rows black, the conversion fails instead of writing them
+                if (seek64(scratch[face], std::size_t(row) * this->faceSize * 3 * sizeof(float)) != 0 ||
+                    std::fread(rowBuffer.data(), sizeof(float), rowBuffer.size(), scratch[face]) != rowBuffer.size()) {
+                    std::cout << "ERROR: Could not read scratch file: " << outBaseName << "_" << face << ".tmp" << std::endl;
+                    removeScratch();
+                    throw(1);
+                }
+                writer.writeScanline(rowBuffer.data());
+            }
+        }
+        if (!facesInMemory) {
+            std::fclose(scratch[face]);
+            scratch[face] = nullptr;
+            std::remove((outBaseName + "_" + std::to_string(face) + ".tmp").c_str());
+        }
+        try {
+            writer.commit();
+        }
+        catch (int) {
+            removeScratch();
+            throw;
+        }
+    }
+    report.addTiming("face output", timer.elapsedMs());
+
+    report.addValue("source", std::to_string(this->srcWidth) + "x" + std::to_string(this->srcHeight));
+    report.addValue("face size", std::to_string(this->faceSize));
+    report.addValue("tiles", std::to_string(tiles.size()) + " of " + std::to_string(tileSize) + "px");
+    report.addValue("source pyramid levels", std::to_string(levels) + " streamed");
+    report.addValue("resident source rows", std::to_string(residentRows) + " (" + Report::formatBytes(windowBytes) + ")");
+    report.addValue("face storage", facesInMemory ? "memory" : "scratch files");
+    report.addValue("memory budget", this->memoryBudget == 0 ? "unlimited" : Report::formatBytes(this->memoryBudget));
+    report.addValue("peak RSS", Report::formatBytes(memoryStats::peakRss()));
+}
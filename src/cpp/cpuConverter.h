@@ -0,0 +1,147 @@
+#ifndef CPUCONVERTER_H
+#define CPUCONVERTER_H
+
+// Include standard libraries
+#include <cstddef>
+#include <string>
+#include <vector>
+// Include own classes
+#include "./fastMath.h"
+#include "./planarImage.h"
+#include "./report.h"
+
+/**
+* \class CpuConverter
+*
+* \brief Converts an equirectangular .hdr file to six cube faces on the CPU without loading the whole source.
+*
+* The source is read scanline by scanline (latitude bands). Like the SourcePyramid of the CpuBackend every row is
+* blurred along the latitude and reduced into the coarser levels as soon as it arrived, so the texels pick their
+* source level like equiToCube.frag.glsl and a reduced face size does not alias. The faces are split into square
+* tiles and each tile knows which levels and rows of those levels it touches. Tiles are rendered as soon as their
+* last row arrived and rows are dropped as soon as no pending tile needs them anymore. Inside a tile the texels are rendered in small blocks
+* ordered by latitude, so the source rows a block reads stay cached for the next one. Finished tiles go either into face buffers in memory
+* or, if those do not fit into the memory budget, into raw scratch files next to the output which are converted
+* to .hdr at the end.
+*
+* The faces use the same orientation as the textures rendered by the Generator with the captureViews matrices.
+**/
+class CpuConverter {
+public:
+    /**
+    * \brief Opens the source file.
+    *
+    * \param std::string& The input images path
+    **/
+    CpuConverter(const std::string&);
+
+    /**
+    * Sets the side width of the cube faces.
+    *
+    * \param unsigned int size The side width. 0 uses a quarter of the source width.
+    **/
+    void setFaceSize(unsigned int size);
+
+    /**
+    * Limits the resident memory the conversion may use. The tile size is reduced until the source window fits.
+    *
+    * \param std::size_t bytes The budget in bytes. 0 means unlimited.
+    **/
+    void setMemoryBudget(std::size_t bytes);
+
+    /**
+    * Sets the approximation of atan2 and asin for the direction to UV mapping.
+    *
+    * \param fastMath::Precision precision The approximation, exact by default
+    **/
+    void setMathPrecision(fastMath::Precision precision);
+
+    /**
+    * Runs the conversion and writes the faces as [outBaseName]_[face].hdr.
+    *
+    * \param std::string& outBaseName Path and name prefix of the face files
+    * \param Report& report Receives timings and memory measurements
+    **/
+    void convert(const std::string& outBaseName, Report& report);
+
+private:
+    /// A rectangular part of a face together with the source levels and rows it reads from.
+    struct Tile {
+        unsigned int face;
+        unsigned int x0;
+        unsigned int y0;
+        unsigned int width;
+        unsigned int height;
+        unsigned int firstLevel;
+        unsigned int lastLevel;
+        /// The first and last row read per level, only set from firstLevel to lastLevel.
+        std::vector<unsigned int> firstRows;
+        std::vector<unsigned int> lastRows;
+        /// The source row after which all rows of the tile are complete.
+        unsigned int readyRow;
+    };
+
+    /// The equirectangular source file.
+    std::string inFilePath;
+    /// Source width in pixels.
+    unsigned int srcWidth = 0;
+    /// Source height in pixels.
+    unsigned int srcHeight = 0;
+    /// The cubes side width and height.
+    unsigned int faceSize = 0;
+    /// Resident memory budget in bytes. 0 is unlimited.
+    std::size_t memoryBudget = 0;
+    /// The approximation of the direction to UV mapping.
+    fastMath::Precision mathPrecision = fastMath::Precision::Exact;
+    /// The size of the pyramid levels the face size samples, see planLevels.
+    std::vector<unsigned int> levelWidths;
+    std::vector<unsigned int> levelHeights;
+    /// Per level and row the source row after which the row is complete.
+    std::vector<std::vector<unsigned int>> rowEnds;
+
+    /// Sets up the pyramid levels the face size samples, like GLBackend::uploadSourceLevels.
+    void planLevels();
+    /**
+    * The source level a texel samples, same as equiToCube.frag.glsl.
+    *
+    * \param float distance2 The squared distance of the texel from the face center, the face spanning [-1, 1]
+    **/
+    float lodAt(float distance2) const;
+
+    /**
+    * Splits all faces into tiles, sorted by the source row after which they can be rendered.
+    *
+    * \param unsigned int tileSize The tiles width and height
+    * \param std::vector<unsigned int> &windowRows Receives per level the number of rows which have to be resident
+    * at once. 0 if no tile reads the level.
+    **/
+    std::vector<Tile> planTiles(unsigned int tileSize, std::vector<unsigned int> &windowRows) const;
+    /**
+    * Maps a face texel to its sampling position in the source.
+    *
+    * \param unsigned int face The cube face index
+    * \param float x The texels x coordinate, pixel centers at .5
+    * \param float y The texels y coordinate, pixel centers at .5. Row 0 is the bottom row as in OpenGL.
+    * \param float &srcX Receives the source column, pixel centers at integers
+    * \param float &srcY Receives the source row counted from the top, pixel centers at integers
+    **/
+    void faceToSource(unsigned int face, float x, float y, float &srcX, float &srcY) const;
+    /**
+    * Maps count consecutive texels of a face row to their sampling positions in the source, like faceToSource.
+    *
+    * \param float x The x coordinate of the first texel
+    * \param unsigned int count The number of texels
+    * \param float* srcX, srcY Receive count source columns and rows
+    **/
+    void rowToSource(unsigned int face, float x, unsigned int count, float y, float* srcX, float* srcY) const;
+    /**
+    * Renders a tile from the resident rows of the levels.
+    *
+    * \param const Tile& tile The tile to render
+    * \param const std::vector<ConstImageView>& windows The ring buffers of rows per level, their height is the capacity
+    * \param const ImageView& out Destination of tile.width x tile.height texels
+    **/
+    void renderTile(const Tile& tile, const std::vector<ConstImageView>& windows, const ImageView& out) const;
+};
+
+#endif // CPUCONVERTER_H
@@ -0,0 +1,12 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+/**
+* Runtime checks of instruction set extensions, so kernels compiled for them are only called where they run.
+**/
+namespace cpuFeatures {
+    /// Whether the CPU and the OS support AVX2. Always false on builds for other architectures than x64.
+    bool hasAvx2();
+}
+
+#endif // CPUFEATURES_H
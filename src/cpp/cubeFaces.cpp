@@ -0,0 +1,67 @@
+// Include own header
+#include "./cubeFaces.h"
+#include "./constants.h"
+// Include standard libraries
+#include <algorithm>
+
+namespace {
+    /// The camera axes of a cube face as set up by its captureViews matrix.
+    struct FaceBasis {
+        glm::vec3 right;
+        glm::vec3 up;
+        glm::vec3 forward;
+    };
+
+    FaceBasis faceBasis(unsigned int face) {
+        // lookAt stores the camera axes in the rows of the upper 3x3 part
+        const glm::mat4& view = captureViews[face];
+        FaceBasis basis;
+        basis.right = glm::vec3(view[0][0], view[1][0], view[2][0]);
+        basis.up = glm::vec3(view[0][1], view[1][1], view[2][1]);
+        basis.forward = -glm::vec3(view[0][2], view[1][2], view[2][2]);
+        return basis;
+    }
+
+    const FaceBasis bases[6] = { faceBasis(0), faceBasis(1), faceBasis(2), faceBasis(3), faceBasis(4), faceBasis(5) };
+}
+
+glm::vec3 cubeFaces::direction(unsigned int face, float x, float y) {
+    const FaceBasis& basis = bases[face];
+    return basis.forward + x * basis.right + y * basis.up;
+}
+
+unsigned int cubeFaces::locate(const glm::vec3& dir, float &x, float &y) {
+    unsigned int face = 0;
+    float best = glm::dot(dir, bases[0].forward);
+    for (unsigned int i = 1; i < 6; ++i) {
+        const float d = glm::dot(dir, bases[i].forward);
+        if (d > best) {
+            best = d;
+            face = i;
+        }
+    }
+    x = glm::dot(dir, bases[face].right) / best;
+    y = glm::dot(dir, bases[face].up) / best;
+    return face;
+}
+
+void cubeFaces::splitIntoBlocks(unsigned int faceSize, const Block& area, unsigned int blockSize, std::vector<Block>& blocks) {
+    for (unsigned int y0 = area.y0; y0 < area.y0 + area.height; y0 += blockSize) {
+        for (unsigned int x0 = area.x0; x0 < area.x0 + area.width; x0 += blockSize) {
+            Block block;
+            block.face = area.face;
+            block.x0 = x0;
+            block.y0 = y0;
+            block.width = std::min(blockSize, area.x0 + area.width - x0);
+            block.height = std::min(blockSize, area.y0 + area.height - y0);
+            const float x = (2.0f * x0 + block.width) / faceSize - 1.0f;
+            const float y = (2.0f * y0 + block.height) / faceSize - 1.0f;
+            block.latitude = glm::normalize(direction(area.face, x, y)).y;
+            blocks.push_back(block);
+        }
+    }
+}
+
+void cubeFaces::sortByLatitude(std::vector<Block>& blocks) {
+    std::stable_sort(blocks.begin(), blocks.end(), [](const Block& a, const Block& b) { return a.latitude > b.latitude; });
+}
@@ -0,0 +1,58 @@
+#ifndef CUBEFACES_H
+#define CUBEFACES_H
+
+// Include standard libraries
+#include <vector>
+// Include glm for vector and matrix operations
+#include "glm/glm.hpp"
+
+/**
+* Geometry of the cube faces as they are rendered with the captureViews matrices. Face coordinates run from -1 to 1,
+* with y pointing to the bottom row 0 of the OpenGL texture upwards.
+**/
+namespace cubeFaces {
+    /**
+    * The not normalized direction through a point of a face.
+    *
+    * \param unsigned int face The face index in OpenGL order (+X, -X, +Y, -Y, +Z, -Z)
+    * \param float x The horizontal face coordinate in [-1, 1]
+    * \param float y The vertical face coordinate in [-1, 1]
+    **/
+    glm::vec3 direction(unsigned int face, float x, float y);
+    /**
+    * The face a direction points to and the face coordinates of the hit point.
+    *
+    * \param const glm::vec3& dir Any direction, does not need to be normalized
+    * \param float &x Receives the horizontal face coordinate in [-1, 1]
+    * \param float &y Receives the vertical face coordinate in [-1, 1]
+    * \return The face index
+    **/
+    unsigned int locate(const glm::vec3& dir, float &x, float &y);
+
+    /// A rectangle of texels of a face, row 0 at the bottom.
+    struct Block {
+        unsigned int face;
+        unsigned int x0;
+        unsigned int y0;
+        unsigned int width;
+        unsigned int height;
+        /// The sine of the latitude of the blocks center, 1 at the north pole.
+        float latitude;
+    };
+    /**
+    * Splits a rectangle of a face into square blocks and appends them.
+    *
+    * \param unsigned int faceSize The side width of the face
+    * \param const Block& area The rectangle to split, its latitude is ignored
+    * \param unsigned int blockSize The blocks width and height, blocks at the right and top border may be smaller
+    * \param std::vector<Block>& blocks Receives the blocks
+    **/
+    void splitIntoBlocks(unsigned int faceSize, const Block& area, unsigned int blockSize, std::vector<Block>& blocks);
+    /**
+    * Orders blocks from north to south. An equirectangular source row is a latitude, so neighbouring blocks in this
+    * order read from the same source rows while they are still cached, no matter which face they belong to.
+    **/
+    void sortByLatitude(std::vector<Block>& blocks);
+}
+
+#endif // CUBEFACES_H
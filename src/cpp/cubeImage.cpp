@@ -0,0 +1,108 @@
+// Include own header
+#include "./cubeImage.h"
+#include "./arena.h"
+#include "./cubeFaces.h"
+// Include standard libraries
+#include <algorithm>
+#include <cmath>
+
+CubeImage::CubeImage(unsigned int size, unsigned int levels, Arena* arena) {
+    this->size = size;
+    if (levels == 0) {
+        levels = fullLevelCount(size);
+    }
+    for (unsigned int level = 0; level < levels; ++level) {
+        const unsigned int levelSize = this->getSize(level);
+        for (unsigned int face = 0; face < 6; ++face) {
+            this->offsets.push_back(this->floats);
+            this->floats += PlanarImage::bytesFor(levelSize, levelSize) / sizeof(float);
+        }
+    }
+    this->data = arena != nullptr ? arena->allocateFloats(this->floats) : PlanarImage::allocate(this->floats);
+}
+
+unsigned int CubeImage::fullLevelCount(unsigned int size) {
+    unsigned int levels = 1;
+    while (size > 1) {
+        size /= 2;
+        levels++;
+    }
+    return levels;
+}
+
+unsigned int CubeImage::getSize(unsigned int level) const {
+    const unsigned int levelSize = this->size >> level;
+    return levelSize > 0 ? levelSize : 1;
+}
+
+unsigned int CubeImage::getLevelCount() const {
+    return (unsigned int)(this->offsets.size() / 6);
+}
+
+ImageView CubeImage::getFace(unsigned int level, unsigned int face) {
+    const unsigned int levelSize = this->getSize(level);
+    const std::size_t stride = PlanarImage::rowStride(levelSize);
+    return ImageView(this->data.get() + this->offsets[level * 6 + face], levelSize, levelSize, stride, stride * levelSize);
+}
+
+ConstImageView CubeImage::getFace(unsigned int level, unsigned int face) const {
+    const unsigned int levelSize = this->getSize(level);
+    const std::size_t stride = PlanarImage::rowStride(levelSize);
+    return ConstImageView(this->data.get() + this->offsets[level * 6 + face], levelSize, levelSize, stride, stride * levelSize);
+}
+
+std::size_t CubeImage::getBytes() const {
+    return this->floats * sizeof(float);
+}
+
+void CubeImage::sample(const glm::vec3& dir, float lod, float* rgb) const {
+    float x, y;
+    const unsigned int face = cubeFaces::locate(dir, x, y);
+    lod = std::min(std::max(lod, 0.0f), float(this->getLevelCount() - 1));
+    const unsigned int level = (unsigned int)lod;
+    const float t = lod - level;
+    this->sampleLevel(level, face, x, y, rgb);
+    if (t > 0.0f) {
+        float next[3];
+        this->sampleLevel(level + 1, face, x, y, next);
+        for (int c = 0; c < 3; ++c) {
+            rgb[c] += (next[c] - rgb[c]) * t;
+        }
+    }
+}
+
+void CubeImage::sampleLevel(unsigned int level, unsigned int face, float x, float y, float* rgb) const {
+    const unsigned int levelSize = this->getSize(level);
+    const float px = (x + 1.0f) * 0.5f * levelSize - 0.5f;
+    const float py = (y + 1.0f) * 0.5f * levelSize - 0.5f;
+    const int x0 = int(std::floor(px));
+    const int y0 = int(std::floor(py));
+    const float fx = px - x0;
+    const float fy = py - y0;
+    float t00[3], t10[3], t01[3], t11[3];
+    this->getTexel(level, face, x0, y0, t00);
+    this->getTexel(level, face, x0 + 1, y0, t10);
+    this->getTexel(level, face, x0, y0 + 1, t01);
+    this->getTexel(level, face, x0 + 1, y0 + 1, t11);
+    for (int c = 0; c < 3; ++c) {
+        const float bottom = t00[c] + (t10[c] - t00[c]) * fx;
+        const float top = t01[c] + (t11[c] - t01[c]) * fx;
+        rgb[c] = bottom + (top - bottom) * fy;
+    }
+}
+
+void CubeImage::getTexel(unsigned int level, unsigned int face, int x, int y, float* rgb) const {
+    const int levelSize = this->getSize(level);
+    if (x < 0 || y < 0 || x >= levelSize || y >= levelSize) {
+        // Follow the direction through the texel center onto the neighbouring face
+        const glm::vec3 dir = cubeFaces::direction(face, 2.0f * (x + 0.5f) / levelSize - 1.0f, 2.0f * (y + 0.5f) / levelSize - 1.0f);
+        float fx, fy;
+        face = cubeFaces::locate(dir, fx, fy);
+        x = std::min(std::max(int(std::floor((fx + 1.0f) * 0.5f * levelSize)), 0), levelSize - 1);
+        y = std::min(std::max(int(std::floor((fy + 1.0f) * 0.5f * levelSize)), 0), levelSize - 1);
+    }
+    const ConstImageView view = this->getFace(level, face);
+    for (unsigned int c = 0; c < 3; ++c) {
+        rgb[c] = view.at(c, x, y);
+    }
+}
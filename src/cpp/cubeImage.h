@@ -0,0 +1,75 @@
+#ifndef CUBEIMAGE_H
+#define CUBEIMAGE_H
+
+// Include standard libraries
+#include <vector>
+// Include own classes
+#include "./planarImage.h"
+// Include glm for vector and matrix operations
+#include "glm/glm.hpp"
+
+/**
+* \class CubeImage
+*
+* A cube map with a mip chain in main memory. Every face of every level is a planar RGB float image (see
+* PlanarView) with the bottom row first, which is the row order glGetTexImage returns for the textures the
+* Generator renders. All faces share one 64 byte aligned allocation.
+**/
+class CubeImage {
+public:
+    /// Creates an empty cube.
+    CubeImage() {}
+    /**
+    * Creates a cube with undefined content.
+    *
+    * \param unsigned int size The side width of level 0
+    * \param unsigned int levels The number of levels. 0 creates the complete chain down to 1x1.
+    * \param Arena* arena Takes the faces from the arena instead of the heap if set
+    **/
+    CubeImage(unsigned int size, unsigned int levels, Arena* arena = nullptr);
+
+    /// The number of levels for a complete chain of the given side width.
+    static unsigned int fullLevelCount(unsigned int size);
+
+    /// The side width of the given level.
+    unsigned int getSize(unsigned int level = 0) const;
+    /// The number of levels.
+    unsigned int getLevelCount() const;
+    /// The planes of a face level.
+    ImageView getFace(unsigned int level, unsigned int face);
+    /// The planes of a face level.
+    ConstImageView getFace(unsigned int level, unsigned int face) const;
+    /// The memory of all levels in bytes.
+    std::size_t getBytes() const;
+    /**
+    * Trilinear lookup like a seamless OpenGL cube map. Bilinear taps beyond a face edge are fetched from the
+    * neighbouring face.
+    *
+    * \param const glm::vec3& dir The direction, does not need to be normalized
+    * \param float lod The mip level, clamped to the existing ones
+    * \param float* rgb Receives the color
+    **/
+    void sample(const glm::vec3& dir, float lod, float* rgb) const;
+    /**
+    * A texel of a level. Texels outside of the face are taken from the neighbouring face the direction through
+    * their center points to.
+    *
+    * \param float* rgb Receives the color
+    **/
+    void getTexel(unsigned int level, unsigned int face, int x, int y, float* rgb) const;
+
+private:
+    /// The side width of level 0.
+    unsigned int size = 0;
+    /// The planes of all face levels.
+    PlanarImage::Buffer data { nullptr, nullptr };
+    /// The offset of every face level in data, ordered by level and then by face.
+    std::vector<std::size_t> offsets;
+    /// The number of floats in data.
+    std::size_t floats = 0;
+
+    /// Bilinear lookup in one level at face coordinates in [-1, 1].
+    void sampleLevel(unsigned int level, unsigned int face, float x, float y, float* rgb) const;
+};
+
+#endif // CUBEIMAGE_H
@@ -0,0 +1,119 @@
+// Include own header
+#include "./cubeMipBuilder.h"
+#include "./parallel.h"
+// Include standard libraries
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CUBEMIPBUILDER_SSE
+#endif
+
+namespace {
+    /// Weights of the [1 3 3 1] tent, normalized for one dimension.
+    const float tapWeights[4] = { 1.0f / 8.0f, 3.0f / 8.0f, 3.0f / 8.0f, 1.0f / 8.0f };
+
+    /**
+    * A face level copied with a one texel border taken from the neighbouring faces.
+    * Texel (x, y) of the face is at (x + 1, y + 1) of the image.
+    **/
+    void padFace(const CubeImage& cube, unsigned int level, unsigned int face, const ImageView& view) {
+        const int size = int(cube.getSize(level));
+        for (int y = -1; y <= size; ++y) {
+            for (int x = -1; x <= size; ++x) {
+                float rgb[3];
+                cube.getTexel(level, face, x, y, rgb);
+                for (unsigned int c = 0; c < 3; ++c) {
+                    view.at(c, x + 1, y + 1) = rgb[c];
+                }
+            }
+        }
+    }
+
+    /// The four source texel indices of the tent around a destination texel.
+    void tapIndices(unsigned int srcSize, unsigned int dstSize, unsigned int dst, int taps[4]) {
+        const float center = (dst + 0.5f) * srcSize / dstSize;
+        for (int i = 0; i < 4; ++i) {
+            taps[i] = int(std::floor(center + i - 1.5f));
+        }
+    }
+
+    /**
+    * Filters one destination row of a face channel, first the four source rows into one padded row, then along it.
+    *
+    * \param const ConstImageView& src The padded source face
+    * \param unsigned int channel The channel to filter
+    * \param const std::vector<int>& cols The four padded source columns of every destination texel
+    * \param unsigned int y The destination row
+    * \param float* column Scratch of src.stride floats, 64 byte aligned
+    * \param float* dstRow Receives the destination row
+    **/
+    void filterRow(const ConstImageView& src, unsigned int channel, const std::vector<int>& cols, unsigned int y, float* column, float* dstRow) {
+        const unsigned int dstSize = (unsigned int)cols.size() / 4;
+        int rows[4];
+        tapIndices(src.width - 2, dstSize, y, rows);
+        const float* taps[4];
+        for (int j = 0; j < 4; ++j) {
+            taps[j] = src.row(channel, rows[j] + 1);
+        }
+        // Rows are aligned and padded to 64 bytes, so whole vectors up to the stride are valid
+#ifdef CUBEMIPBUILDER_SSE
+        for (std::size_t x = 0; x < src.stride; x += 4) {
+            __m128 sum = _mm_mul_ps(_mm_load_ps(taps[0] + x), _mm_set1_ps(tapWeights[0]));
+            for (int j = 1; j < 4; ++j) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(taps[j] + x), _mm_set1_ps(tapWeights[j])));
+            }
+            _mm_store_ps(column + x, sum);
+        }
+#else
+        for (std::size_t x = 0; x < src.stride; ++x) {
+            column[x] = taps[0][x] * tapWeights[0] + taps[1][x] * tapWeights[1] + taps[2][x] * tapWeights[2] + taps[3][x] * tapWeights[3];
+        }
+#endif
+        for (unsigned int x = 0; x < dstSize; ++x) {
+            const int* tap = &cols[x * 4];
+            dstRow[x] = column[tap[0]] * tapWeights[0] + column[tap[1]] * tapWeights[1] + column[tap[2]] * tapWeights[2] + column[tap[3]] * tapWeights[3];
+        }
+    }
+}
+
+void cubeMipBuilder::build(CubeImage& cube, Report& report, Arena& arena) {
+    for (unsigned int level = 1; level < cube.getLevelCount(); ++level) {
+        Timer timer;
+        const ArenaScope scope(arena);
+        const unsigned int srcSize = cube.getSize(level - 1);
+        const unsigned int dstSize = cube.getSize(level);
+        PlanarImage padded[6];
+        for (unsigned int face = 0; face < 6; ++face) {
+            padded[face] = PlanarImage(srcSize + 2, srcSize + 2, &arena);
+        }
+        parallel::forEach(6, [&](unsigned int face) {
+            padFace(cube, level - 1, face, padded[face].getView());
+        });
+        // The columns are the same for every row, indices are shifted into the padded face
+        std::vector<int> cols(dstSize * 4);
+        for (unsigned int x = 0; x < dstSize; ++x) {
+            tapIndices(srcSize, dstSize, x, &cols[x * 4]);
+            for (int i = 0; i < 4; ++i) {
+                cols[x * 4 + i]++;
+            }
+        }
+        parallel::forEach(6 * dstSize, [&](unsigned int item) {
+            const unsigned int face = item / dstSize;
+            const unsigned int y = item % dstSize;
+            const ConstImageView src = padded[face].getView();
+            const ImageView dst = cube.getFace(level, face);
+            // Every worker takes the row from its own scratch arena
+            Arena& scratch = Arena::scratch();
+            const ArenaScope rowScope(scratch);
+            float* column = (float*)scratch.allocate(src.stride * sizeof(float));
+            for (unsigned int c = 0; c < 3; ++c) {
+                filterRow(src, c, cols, y, column, dst.row(c, y));
+            }
+        });
+        report.addTiming("cube mip level " + std::to_string(level) + " (" + std::to_string(dstSize) + "px)", timer.elapsedMs());
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef CUBEMIPBUILDER_H
+#define CUBEMIPBUILDER_H
+
+// Include own classes
+#include "./arena.h"
+#include "./cubeImage.h"
+#include "./report.h"
+
+/**
+* \brief Builds the mip chain of a cube map on the CPU.
+*
+* glGenerateMipmap filters every face on its own, so the edge texels of the smaller levels only see one face and
+* seams show up in rough reflections. This builder filters with a separable 4 tap tent [1 3 3 1] which reaches one
+* texel across the face edges. The missing texels are fetched from the neighbouring faces through the cube geometry,
+* so the filter is continuous over the edges. Rows are spread over all cores. The tent is applied separable on the
+* planes: the vertical taps combine whole aligned source rows with 4 wide SIMD, then the horizontal taps are applied
+* along the combined row.
+**/
+namespace cubeMipBuilder {
+    /**
+    * Fills levels 1 to cube.getLevelCount() - 1 from level 0.
+    *
+    * \param CubeImage& cube The cube, level 0 has to be filled
+    * \param Report& report Receives the time spent on every level
+    * \param Arena& arena Supplies the padded copies of the faces, it is rewound when done
+    **/
+    void build(CubeImage& cube, Report& report, Arena& arena);
+}
+
+#endif // CUBEMIPBUILDER_H
@@ -0,0 +1,97 @@
+// Include own header
+#include "./faceTables.h"
+#include "./cubeFaces.h"
+#include "./parallel.h"
+// Include standard libraries
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+namespace {
+    std::mutex cacheMutex;
+    std::map<unsigned int, std::shared_ptr<const FaceTables>> cache;
+
+    /// The solid angle of the face area from the center to the face point (x, y), signed by quadrant.
+    double areaElement(double x, double y) {
+        return std::atan2(x * y, std::sqrt(x * x + y * y + 1.0));
+    }
+}
+
+std::shared_ptr<const FaceTables> FaceTables::get(unsigned int size, Report& report) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto cached = cache.find(size);
+    if (cached != cache.end()) {
+        return cached->second;
+    }
+    Timer timer;
+    std::shared_ptr<const FaceTables> tables(new FaceTables(size));
+    cache[size] = tables;
+    std::ostringstream value;
+    value << std::fixed << std::setprecision(1) << timer.elapsedMs() << " ms build, " << Report::formatBytes(tables->getBytes());
+    report.addValue("face tables " + std::to_string(size) + "px", value.str());
+    return tables;
+}
+
+std::size_t FaceTables::getCachedBytes() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::size_t bytes = 0;
+    for (const auto& entry : cache) {
+        bytes += entry.second->getBytes();
+    }
+    return bytes;
+}
+
+void FaceTables::releaseCache() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache.clear();
+}
+
+FaceTables::FaceTables(unsigned int size) : size(size) {
+    const std::size_t faceTexels = std::size_t(size) * size;
+    this->x.resize(faceTexels * 6);
+    this->y.resize(faceTexels * 6);
+    this->z.resize(faceTexels * 6);
+    this->solidAngle.resize(faceTexels * 6);
+    const double texel = 2.0 / size;
+    parallel::forEach(6 * size, [&](unsigned int item) {
+        const unsigned int face = item / size;
+        const unsigned int row = item % size;
+        const double v0 = row * texel - 1.0;
+        for (unsigned int column = 0; column < size; ++column) {
+            const std::size_t i = face * faceTexels + std::size_t(row) * size + column;
+            const double u0 = column * texel - 1.0;
+            const glm::vec3 dir = glm::normalize(cubeFaces::direction(face, float(u0 + 0.5 * texel), float(v0 + 0.5 * texel)));
+            this->x[i] = dir.x;
+            this->y[i] = dir.y;
+            this->z[i] = dir.z;
+            this->solidAngle[i] = float(areaElement(u0, v0) - areaElement(u0, v0 + texel) - areaElement(u0 + texel, v0) + areaElement(u0 + texel, v0 + texel));
+        }
+    });
+}
+
+unsigned int FaceTables::getSize() const {
+    return this->size;
+}
+
+const float* FaceTables::getX(unsigned int face) const {
+    return &this->x[std::size_t(face) * this->size * this->size];
+}
+
+const float* FaceTables::getY(unsigned int face) const {
+    return &this->y[std::size_t(face) * this->size * this->size];
+}
+
+const float* FaceTables::getZ(unsigned int face) const {
+    return &this->z[std::size_t(face) * this->size * this->size];
+}
+
+const float* FaceTables::getSolidAngle(unsigned int face) const {
+    return &this->solidAngle[std::size_t(face) * this->size * this->size];
+}
+
+std::size_t FaceTables::getBytes() const {
+    return (this->x.size() + this->y.size() + this->z.size() + this->solidAngle.size()) * sizeof(float);
+}
@@ -0,0 +1,56 @@
+#ifndef FACETABLES_H
+#define FACETABLES_H
+
+// Include standard libraries
+#include <memory>
+#include <vector>
+// Include own classes
+#include "./report.h"
+
+/**
+* \class FaceTables
+*
+* \brief The normalized direction and the solid angle of every texel of a cube with a given side width.
+*
+* The tables are stored as separate float arrays (x, y, z, solid angle) per face in the texel order of CubeImage,
+* bottom row first. They are built once per side width and cached for the whole process, so all stages and all
+* jobs with the same face size share them. The solid angles are exact and sum up to 4 PI.
+**/
+class FaceTables {
+public:
+    /**
+    * The tables of a side width, built on the first request.
+    *
+    * \param unsigned int size The side width of the faces
+    * \param Report& report Receives the build time and the memory when the tables are built
+    **/
+    static std::shared_ptr<const FaceTables> get(unsigned int size, Report& report);
+    /// The memory of all cached tables in bytes.
+    static std::size_t getCachedBytes();
+    /// Empties the cache. Tables still in use are freed by their last user.
+    static void releaseCache();
+
+    /// The side width.
+    unsigned int getSize() const;
+    /// The x components of the directions of a face.
+    const float* getX(unsigned int face) const;
+    /// The y components of the directions of a face.
+    const float* getY(unsigned int face) const;
+    /// The z components of the directions of a face.
+    const float* getZ(unsigned int face) const;
+    /// The solid angles of the texels of a face in steradian.
+    const float* getSolidAngle(unsigned int face) const;
+    /// The memory of the tables in bytes.
+    std::size_t getBytes() const;
+
+private:
+    /// Builds the tables, see get.
+    explicit FaceTables(unsigned int size);
+
+    /// The side width.
+    unsigned int size;
+    /// size * size values per face, face after face.
+    std::vector<float> x, y, z, solidAngle;
+};
+
+#endif // FACETABLES_H
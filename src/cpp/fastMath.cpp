@@ -0,0 +1,281 @@
+// Include own header
+#include "./fastMath.h"
+#include "./cpuFeatures.h"
+#include "./faceTables.h"
+// Include standard libraries
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FASTMATH_AVX2
+#if defined(_MSC_VER)
+// MSVC accepts AVX2 intrinsics without /arch:AVX2, the kernel is only called after the CPU check
+#define FASTMATH_TARGET_AVX2
+#else
+#define FASTMATH_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+    const float PI = 3.14159265359f;
+    const float HALF_PI = 1.57079632679f;
+
+    /// Coefficients of atan(t) = t * P(t^2) for t in [0, 1], Abramowitz and Stegun 4.4.49 and 4.4.47.
+    const float atanHigh[8] = { 1.0f, -0.3333314528f, 0.1999355085f, -0.1420889944f, 0.1065626393f, -0.0752896400f, 0.0429096138f, -0.0161657367f };
+    const float atanHighLast = 0.0028662257f;
+    const float atanFast[5] = { 0.9998660f, -0.3302995f, 0.1801410f, -0.0851330f, 0.0208351f };
+    /// Coefficients of acos(x) = sqrt(1 - x) * P(x) for x in [0, 1], Abramowitz and Stegun 4.4.46 and 4.4.45.
+    const float acosHigh[8] = { 1.5707963050f, -0.2145988016f, 0.0889789874f, -0.0501743046f, 0.0308918810f, -0.0170881256f, 0.0066700901f, -0.0012624911f };
+    const float acosFast[4] = { 1.5707288f, -0.2121144f, 0.0742610f, -0.0187293f };
+
+    /// Horner evaluation of c[0] + c[1] x + ... + c[n - 1] x^(n - 1).
+    float horner(const float* c, int n, float x) {
+        float result = c[n - 1];
+        for (int i = n - 2; i >= 0; --i) {
+            result = result * x + c[i];
+        }
+        return result;
+    }
+
+    /// atan(t) for t in [0, 1].
+    float atanUnit(float t, fastMath::Precision precision) {
+        const float t2 = t * t;
+        if (precision == fastMath::Precision::High) {
+            const float t4 = t2 * t2;
+            const float t16 = (t4 * t4) * (t4 * t4);
+            return t * (horner(atanHigh, 8, t2) + atanHighLast * t16);
+        }
+        return t * horner(atanFast, 5, t2);
+    }
+
+    /// acos(a) for a in [0, 1].
+    float acosUnit(float a, fastMath::Precision precision) {
+        const float p = precision == fastMath::Precision::High ? horner(acosHigh, 8, a) : horner(acosFast, 4, a);
+        return std::sqrt(1.0f - a) * p;
+    }
+
+#ifdef FASTMATH_AVX2
+    FASTMATH_TARGET_AVX2
+    __m256 horner8(const float* c, int n, __m256 x) {
+        __m256 result = _mm256_set1_ps(c[n - 1]);
+        for (int i = n - 2; i >= 0; --i) {
+            result = _mm256_add_ps(_mm256_mul_ps(result, x), _mm256_set1_ps(c[i]));
+        }
+        return result;
+    }
+
+    /// The AVX2 version of directionsToUv for the polynomial precisions. Returns the number of directions done.
+    FASTMATH_TARGET_AVX2
+    std::size_t directionsToUvAvx2(const float* x, const float* y, const float* z, std::size_t count, float* u, float* v, fastMath::Precision precision) {
+        const bool high = precision == fastMath::Precision::High;
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 pi = _mm256_set1_ps(PI);
+        const __m256 halfPi = _mm256_set1_ps(HALF_PI);
+        const __m256 tiny = _mm256_set1_ps(1e-30f);
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m256 dx = _mm256_loadu_ps(x + i);
+            const __m256 dy = _mm256_loadu_ps(y + i);
+            const __m256 dz = _mm256_loadu_ps(z + i);
+
+            // atan2(z, x) reduced to atan(t) with t in [0, 1]
+            const __m256 ax = _mm256_andnot_ps(signMask, dx);
+            const __m256 az = _mm256_andnot_ps(signMask, dz);
+            const __m256 t = _mm256_div_ps(_mm256_min_ps(ax, az), _mm256_max_ps(_mm256_max_ps(ax, az), tiny));
+            const __m256 t2 = _mm256_mul_ps(t, t);
+            __m256 p;
+            if (high) {
+                const __m256 t4 = _mm256_mul_ps(t2, t2);
+                const __m256 t16 = _mm256_mul_ps(_mm256_mul_ps(t4, t4), _mm256_mul_ps(t4, t4));
+                p = _mm256_add_ps(horner8(atanHigh, 8, t2), _mm256_mul_ps(_mm256_set1_ps(atanHighLast), t16));
+            }
+            else {
+                p = horner8(atanFast, 5, t2);
+            }
+            __m256 angle = _mm256_mul_ps(t, p);
+            angle = _mm256_blendv_ps(angle, _mm256_sub_ps(halfPi, angle), _mm256_cmp_ps(az, ax, _CMP_GT_OQ));
+            angle = _mm256_blendv_ps(angle, _mm256_sub_ps(pi, angle), _mm256_cmp_ps(dx, _mm256_setzero_ps(), _CMP_LT_OQ));
+            angle = _mm256_or_ps(angle, _mm256_and_ps(dz, signMask));
+            _mm256_storeu_ps(u + i, _mm256_add_ps(_mm256_mul_ps(angle, _mm256_set1_ps(0.5f / PI)), half));
+
+            // asin(y) = PI / 2 - acos(|y|) with the sign of y
+            const __m256 ay = _mm256_min_ps(_mm256_andnot_ps(signMask, dy), one);
+            const __m256 q = high ? horner8(acosHigh, 8, ay) : horner8(acosFast, 4, ay);
+            __m256 latitude = _mm256_sub_ps(halfPi, _mm256_mul_ps(_mm256_sqrt_ps(_mm256_sub_ps(one, ay)), q));
+            latitude = _mm256_or_ps(latitude, _mm256_and_ps(dy, signMask));
+            _mm256_storeu_ps(v + i, _mm256_add_ps(_mm256_mul_ps(latitude, _mm256_set1_ps(1.0f / PI)), half));
+        }
+        return i;
+    }
+#endif
+
+    /// Measures the maximum error of a function against its double version over n evenly spread arguments.
+    template <typename Approx, typename Exact>
+    double maxError(double from, double to, Approx approx, Exact exact) {
+        const int n = 1 << 20;
+        double worst = 0.0;
+        for (int i = 0; i <= n; ++i) {
+            const float a = float(from + (to - from) * i / n);
+            worst = std::max(worst, std::abs(double(approx(a)) - exact(double(a))));
+        }
+        return worst;
+    }
+}
+
+bool fastMath::parsePrecision(const std::string& name, Precision& precision) {
+    if (name == "exact") {
+        precision = Precision::Exact;
+    }
+    else if (name == "high") {
+        precision = Precision::High;
+    }
+    else if (name == "fast") {
+        precision = Precision::Fast;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+std::string fastMath::getName(Precision precision) {
+    switch (precision) {
+    case Precision::Exact:
+        return "exact";
+    case Precision::High:
+        return "high";
+    default:
+        return "fast";
+    }
+}
+
+float fastMath::atan2(float y, float x, Precision precision) {
+    if (precision == Precision::Exact) {
+        return std::atan2(y, x);
+    }
+    const float ax = std::abs(x);
+    const float ay = std::abs(y);
+    const float maxAxis = std::max(ax, ay);
+    if (maxAxis == 0.0f) {
+        return 0.0f;
+    }
+    float angle = atanUnit(std::min(ax, ay) / maxAxis, precision);
+    if (ay > ax) {
+        angle = HALF_PI - angle;
+    }
+    if (x < 0.0f) {
+        angle = PI - angle;
+    }
+    return std::signbit(y) ? -angle : angle;
+}
+
+float fastMath::asin(float x, Precision precision) {
+    if (precision == Precision::Exact) {
+        return std::asin(x);
+    }
+    const float angle = HALF_PI - acosUnit(std::min(std::abs(x), 1.0f), precision);
+    return x < 0.0f ? -angle : angle;
+}
+
+float fastMath::acos(float x, Precision precision) {
+    if (precision == Precision::Exact) {
+        return std::acos(x);
+    }
+    const float angle = acosUnit(std::min(std::abs(x), 1.0f), precision);
+    return x < 0.0f ? PI - angle : angle;
+}
+
+void fastMath::directionsToUv(const float* x, const float* y, const float* z, std::size_t count, float* u, float* v, Precision precision) {
+    std::size_t i = 0;
+#ifdef FASTMATH_AVX2
+    if (precision != Precision::Exact && cpuFeatures::hasAvx2()) {
+        i = directionsToUvAvx2(x, y, z, count, u, v, precision);
+    }
+#endif
+    for (; i < count; ++i) {
+        u[i] = atan2(z[i], x[i], precision) * (0.5f / PI) + 0.5f;
+        v[i] = asin(std::min(std::max(y[i], -1.0f), 1.0f), precision) * (1.0f / PI) + 0.5f;
+    }
+}
+
+void fastMath::benchmark(unsigned int faceSize, Report& report) {
+    const std::shared_ptr<const FaceTables> tables = FaceTables::get(faceSize, report);
+    const std::size_t faceTexels = std::size_t(faceSize) * faceSize;
+    const double srcWidth = 4.0 * faceSize;
+    const double srcHeight = 2.0 * faceSize;
+    std::vector<float> u(faceTexels), v(faceTexels);
+    report.addValue("math source", std::to_string(unsigned(srcWidth)) + "x" + std::to_string(unsigned(srcHeight)) +
+        " for " + std::to_string(faceSize) + "px faces, batch kernel " + (cpuFeatures::hasAvx2() ? "avx2" : "scalar"));
+
+    const Precision precisions[3] = { Precision::Exact, Precision::High, Precision::Fast };
+    for (Precision precision : precisions) {
+        const std::string name = "math " + getName(precision);
+        // Angular error of the single functions over their whole domain
+        const double atanError = maxError(-PI, PI, [&](float a) { return atan2(std::sin(a), std::cos(a), precision); },
+            [](double a) { return std::atan2(double(std::sin(float(a))), double(std::cos(float(a)))); });
+        const double asinError = maxError(-1.0, 1.0, [&](float a) { return asin(a, precision); }, [](double a) { return std::asin(a); });
+        const double acosError = maxError(-1.0, 1.0, [&](float a) { return acos(a, precision); }, [](double a) { return std::acos(a); });
+        std::ostringstream errors;
+        errors << std::scientific << std::setprecision(1) << "atan2 " << atanError << ", asin " << asinError << ", acos " << acosError << " rad";
+        report.addValue(name + " max angle error", errors.str());
+
+        // Worst UV error over every texel direction of the cube
+        double worstU = 0.0;
+        double worstV = 0.0;
+        for (unsigned int face = 0; face < 6; ++face) {
+            const float* x = tables->getX(face);
+            const float* y = tables->getY(face);
+            const float* z = tables->getZ(face);
+            directionsToUv(x, y, z, faceTexels, u.data(), v.data(), precision);
+            for (std::size_t i = 0; i < faceTexels; ++i) {
+                const double exactU = std::atan2(double(z[i]), double(x[i])) / (2.0 * 3.14159265358979) + 0.5;
+                const double exactV = std::asin(std::min(std::max(double(y[i]), -1.0), 1.0)) / 3.14159265358979 + 0.5;
+                double du = std::abs(u[i] - exactU);
+                // u wraps around at the seam
+                du = std::min(du, 1.0 - du);
+                worstU = std::max(worstU, du * srcWidth);
+                worstV = std::max(worstV, std::abs(v[i] - exactV) * srcHeight);
+            }
+        }
+        std::ostringstream uvError;
+        uvError << std::fixed << std::setprecision(4) << worstU << " texels u, " << worstV << " texels v";
+        report.addValue(name + " worst uv error", uvError.str());
+
+        // Throughput of the batch and of the scalar functions over the whole cube
+        const unsigned int rounds = std::max(1u, unsigned(16777216 / (6 * faceTexels)));
+        Timer timer;
+        for (unsigned int round = 0; round < rounds; ++round) {
+            for (unsigned int face = 0; face < 6; ++face) {
+                directionsToUv(tables->getX(face), tables->getY(face), tables->getZ(face), faceTexels, u.data(), v.data(), precision);
+            }
+        }
+        const double batchMs = timer.elapsedMs();
+        timer.restart();
+        float checksum = 0.0f;
+        for (unsigned int round = 0; round < rounds; ++round) {
+            for (unsigned int face = 0; face < 6; ++face) {
+                const float* x = tables->getX(face);
+                const float* y = tables->getY(face);
+                const float* z = tables->getZ(face);
+                for (std::size_t i = 0; i < faceTexels; ++i) {
+                    checksum += atan2(z[i], x[i], precision) + asin(y[i], precision);
+                }
+            }
+        }
+        const double scalarMs = timer.elapsedMs();
+        // Keeps the compiler from dropping the scalar loop
+        volatile float sink = checksum;
+        (void)sink;
+        const double directions = double(rounds) * 6 * faceTexels;
+        std::ostringstream throughput;
+        throughput << std::fixed << std::setprecision(1) << directions / (batchMs * 1000.0) << " Mdirections/s batch, "
+            << directions / (scalarMs * 1000.0) << " scalar";
+        report.addValue(name + " throughput", throughput.str());
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+// Include standard libraries
+#include <cstddef>
+#include <string>
+// Include own classes
+#include "./report.h"
+
+/**
+* \brief Polynomial approximations of atan2, asin and acos for the direction to equirectangular UV mapping.
+*
+* The polynomials are the minimax fits of Abramowitz and Stegun, 4.4.45 to 4.4.49. The maximum angular errors
+* below are the ones of the fits; in float the result additionally carries the rounding of the evaluation, which
+* benchmark() measures.
+*
+* | Precision | atan2                  | asin, acos              |
+* |-----------|------------------------|-------------------------|
+* | Exact     | std::atan2             | std::asin, std::acos    |
+* | High      | 8 terms, 2e-8 rad      | 8 terms, 2e-8 rad       |
+* | Fast      | 5 terms, 1e-5 rad      | 4 terms, 6.7e-5 rad     |
+*
+* High is as accurate as float allows. Fast stays below 0.2 source texels up to 16k sources.
+**/
+namespace fastMath {
+    enum class Precision {Exact, High, Fast};
+
+    /**
+    * The precision of a name.
+    *
+    * \param std::string& name exact, high or fast
+    * \param Precision& precision Receives the precision
+    * \return False if the name is unknown
+    **/
+    bool parsePrecision(const std::string& name, Precision& precision);
+    /// The name of a precision.
+    std::string getName(Precision precision);
+
+    float atan2(float y, float x, Precision precision);
+    float asin(float x, Precision precision);
+    float acos(float x, Precision precision);
+
+    /**
+    * Maps normalized directions to the coordinates of SampleSphericalMap in equiToCube.frag.glsl,
+    * u = atan2(z, x) / 2 PI + 0.5 and v = asin(y) / PI + 0.5. Uses AVX2 for 8 directions at once if the CPU has it.
+    *
+    * \param const float* x, y, z The direction components, count values each
+    * \param std::size_t count The number of directions
+    * \param float* u, v Receive the coordinates, count values each
+    * \param Precision precision The approximation to use
+    **/
+    void directionsToUv(const float* x, const float* y, const float* z, std::size_t count, float* u, float* v, Precision precision);
+
+    /**
+    * Measures every precision against double precision and its throughput. The worst UV error is taken over all
+    * texel directions of a cube with the given face size and expressed in texels of the matching source, which is
+    * 4 faceSize x 2 faceSize texels.
+    *
+    * \param unsigned int faceSize The target face size
+    * \param Report& report Receives the errors and the throughput
+    **/
+    void benchmark(unsigned int faceSize, Report& report);
+}
+
+#endif // FASTMATH_H
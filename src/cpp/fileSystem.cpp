@@ -0,0 +1,35 @@
+// Include own header
+#include "./fileSystem.h"
+// Include standard libraries
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+bool fileSystem::isDirectory(const std::string& path) {
+    struct stat sb;
+    return stat(path.c_str(), &sb) == 0 && (sb.st_mode & S_IFMT) == S_IFDIR;
+}
+
+bool fileSystem::makeDirectories(const std::string& path) {
+    if (path.empty()) {
+        return false;
+    }
+    // Every prefix up to a separator is a parent, the root and drive letters already exist
+    for (std::size_t end = path.find_first_of("\\/", 1); ; end = path.find_first_of("\\/", end + 1)) {
+        const std::string part = path.substr(0, end);
+        if (!part.empty() && part.back() != ':' && !isDirectory(part)) {
+#ifdef _WIN32
+            _mkdir(part.c_str());
+#else
+            mkdir(part.c_str(), 0777);
+#endif
+        }
+        if (end == std::string::npos) {
+            break;
+        }
+    }
+    return isDirectory(path);
+}
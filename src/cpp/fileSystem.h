@@ -0,0 +1,23 @@
+#ifndef FILESYSTEM_H
+#define FILESYSTEM_H
+
+// Include standard libraries
+#include <string>
+
+/**
+* Directory handling without the shell. Paths may come from socket clients of -serve, so they are never pasted into
+* a command line.
+**/
+namespace fileSystem {
+    /**
+    * Creates a directory and its missing parents, like mkdir of cmd.exe. Both \ and / separate the parts.
+    *
+    * \param std::string& path The directory
+    * \return true if the path is a directory afterwards
+    **/
+    bool makeDirectories(const std::string& path);
+    /// Whether the path exists and is a directory.
+    bool isDirectory(const std::string& path);
+}
+
+#endif // FILESYSTEM_H
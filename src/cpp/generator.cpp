@@ -1,33 +1,70 @@
 // Include own header
 #include "./generator.h"
-#include "./constants.h"
+#include "./faceTables.h"
+#include "./fileSystem.h"
+#include "./hdrio.h"
+#include "./memoryStats.h"
+#include "./shIrradiance.h"
 // Include standard lib for filesystem calls
 #include <cstdlib>
+// Include algorithm for min and max
+#include <algorithm>
+// Include the math and formatting of the error report
+#include <cmath>
+#include <iomanip>
+#include <sstream>
 // Include stat for existence check
 #include <sys/types.h>
 #include <sys/stat.h>
-// Include glad for OpenGL function pointers
-#include "glad/glad.h"
-// Include GLFW for window context. OpenGL does not work without...
-#include "GLFW/glfw3.h"
-// Include glm for vector and matrix operations
-#include "glm/glm.hpp"
-#include "glm/gtc/matrix_transform.hpp"
-// Include Developers Image Library (DevIL)
-#ifndef ILUT_USE_OPENGL
-    // This MUST be defined before calling the DevIL headers or we don't get OpenGL functionality
-#define ILUT_USE_OPENGL
-#endif
-#include "IL/il.h"
-#include "IL/ilu.h"
-#include "IL/ilut.h"
-
-// Forward declaration... GLFW does not like the callback inside the class structure.
-void window_size_callback(GLFWwindow* window, int width, int height);
+
+namespace {
+    /// The smallest face size fitTimeBudget halves down to.
+    const unsigned int minBudgetFaceSize = 64;
+
+    double cubeTexels(unsigned int size) {
+        return 6.0 * size * size;
+    }
+
+    /// The work of the irradiance stage, the texels of the map plus the projected ones for spherical harmonics.
+    double irradianceWork(IrradianceMethod method, unsigned int irradianceSize, unsigned int faceSize) {
+        if (method == IrradianceMethod::SphericalHarmonics) {
+            return cubeTexels(irradianceSize) + cubeTexels(faceSize >> shIrradiance::projectionLevel(faceSize));
+        }
+        return cubeTexels(irradianceSize);
+    }
+
+    /// The samples of the prefiltered chain. Level 0 is copied, which costs about one sample per texel.
+    double prefilterWork(const std::vector<unsigned int>& counts, unsigned int faceSize) {
+        double work = 0.0;
+        for (unsigned int level = 0; level < counts.size(); ++level) {
+            work += cubeTexels(std::max(faceSize >> level, 1u)) * (level == 0 ? 1 : counts[level]);
+        }
+        return work;
+    }
+}
 
 Generator::Generator(const std::string& in) : Generator(in, "out") {}
 
-Generator::Generator(const std::string& in, const std::string& out) {
+Generator::Generator(const std::string& in, const std::string& out, const std::string& backend, Arena* arena) : Generator(backend, arena) {
+    this->loadSource(in);
+    this->setOutPath(out);
+}
+
+Generator::Generator(const std::string& backend, Arena* arena) {
+    if (arena == nullptr) {
+        this->ownArena.reset(new Arena());
+        arena = this->ownArena.get();
+    }
+    this->arena = arena;
+
+    this->backend = Backend::create(backend, this->report, *this->arena);
+    if (!this->backend) {
+        std::cout << "ERROR: Unknown backend: " << backend << std::endl;
+        throw(3);
+    }
+}
+
+void Generator::loadSource(const std::string& in) {
     // First check for existence of the input file
     struct stat sb;
     try {
@@ -51,7 +88,6 @@ Generator::Generator(const std::string& in, const std::string& out) {
 
     // init the pathes for read and write operations
     this->inFilePath = in;
-    this->setOutPath(out);
     // extract the input files name
     std::size_t dotPos = in.rfind(".hdr");
     std::size_t sepPos = in.rfind('/');
@@ -64,56 +100,22 @@ Generator::Generator(const std::string& in, const std::string& out) {
         this->outFileName = in.substr(0, dotPos - 1);
     }
 
-    // glfw: initialize and configure
-    if (!glfwInit()) {
-        std::cout << "Failed to init GLFW" << std::endl;
-    }
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    // glfw window creation
-    this->window = glfwCreateWindow(1, 1, "EnvMapGen", NULL, NULL);
-    if (window == NULL)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-    }
-    glfwHideWindow(window);
-    glfwSetWindowSize(window, SRC_WIDTH, SRC_HEIGHT);
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, window_size_callback);
-
-    // glad: load all OpenGL function pointers
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
-    }
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL); // set depth function to less than AND equal for skybox depth trick.
-    glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS); // enable to avoid seams
-    glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
-
-    // Developers Image Library
-    if (ilGetInteger(IL_VERSION_NUM) < IL_VERSION ||
-        iluGetInteger(ILU_VERSION_NUM) < ILU_VERSION ||
-        ilutGetInteger(ILUT_VERSION_NUM) < ILUT_VERSION) {
-        printf("DevIL version is different...exiting!\n");
-    }
-    ilInit();
+    // Everything of the previous job is returned in one go, the chunks are reused
+    this->arena->reset();
+    Arena::resetScratchStatistics();
+    this->budgetMs = 0.0;
+    this->predictedMs = 0.0;
 
     // Get started :-)
-    this->initShader();
     this->loadSrcImg();
 }
 
-Generator::~Generator() {
-    glfwTerminate();
-}
+Generator::~Generator() {}
 
 void Generator::setOutPath(const std::string& out) {
 
-    std::string command = "mkdir " + out;
-    system(command.c_str());
+    // No shell, the path may come from a client of -serve
+    fileSystem::makeDirectories(out);
 
     struct stat sb;
     try {
@@ -122,10 +124,8 @@ void Generator::setOutPath(const std::string& out) {
         }
         if ((sb.st_mode & S_IFMT) == S_IFDIR) {
             this->outPath = out;
-            command = "mkdir " + out + "\\env";
-            system(command.c_str());
-            command = "mkdir " + out + "\\irradiance";
-            system(command.c_str());
+            fileSystem::makeDirectories(out + "/env");
+            fileSystem::makeDirectories(out + "/irradiance");
         }
         else {
             throw(2);
@@ -147,352 +147,403 @@ void Generator::setMaxMipLevels(const int mips) {
     this->maxMipLevels = mips;
 }
 
-GLFWwindow* Generator::getWindow() const {
-    return this->window;
+void Generator::setCpuMipmaps(const bool enable) {
+    this->backend->setCpuMipmaps(enable);
 }
 
-void Generator::saveCubeMap() const {
-    saveCubeImages(captureColorbuffer, "background_" + this->outFileName);
+void Generator::setMathPrecision(const fastMath::Precision precision) {
+    this->backend->setMathPrecision(precision);
 }
 
-void Generator::saveIrradianceMap() const {
-    saveCubeImages(irradianceColorbuffer, "irradiance_" + this->outFileName, "irradiance");
+void Generator::setLowMemory(const bool enable) {
+    this->lowMemory = enable;
+    this->backend->setLowMemory(enable);
 }
 
-void Generator::savePrefilteredEnvMap() const {
-    for (int i = 0; i < 6; i++) {
-        glBindTexture(GL_TEXTURE_CUBE_MAP, this->environmentColorbuffer);
-        for (int j = 0; j < this->maxMipLevels; j++) {
-            GLint width, height, internalFormat;
-            std::string fileName = this->outPath + "/env" + "/environment_" + this->outFileName + "_" + std::to_string(j) + "_" + std::to_string(i) + ".hdr";
+void Generator::setCompareShaderVariants(const bool enable) {
+    this->backend->setCompareShaderVariants(enable);
+}
 
-            glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, j, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat); // get internal format type of GL texture
-            glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, j, GL_TEXTURE_WIDTH, &width); // get width of GL texture
-            glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, j, GL_TEXTURE_HEIGHT, &height); // get height of GL texture
-
-            if (internalFormat == GL_RGB16F)
-            {
-                GLint size = width * height * 3;
-                float* buffer = new float[size];
-                glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, j, GL_RGB, GL_FLOAT, buffer);
-
-                // Save to an Image
-                ILuint imageID = 0;
-                ilGenImages(1, &imageID);
-                ilBindImage(imageID);
-                ilTexImage(width, height, 0, 3, IL_RGB, IL_FLOAT, buffer);
-                iluFlipImage();
-                ilSave(IL_HDR, fileName.c_str());
-
-                delete[] buffer;
-            }
-            else {
-                std::cout << "ERROR: No HDR Image. Format: " << std::to_string(internalFormat) << std::endl;
-            }
-        }
-    }
+void Generator::setSampleSchedule(const sampleSchedule::Spec& schedule) {
+    this->schedule = schedule;
 }
 
-std::ostream& operator<<(std::ostream& output, const Generator& gen) {
-    output << gen.inFilePath << std::endl;
-    output << gen.outPath << std::endl;
-    return output;
+void Generator::setSampleErrorReport(const bool enable) {
+    this->sampleErrorReport = enable;
 }
 
-void Generator::loadSrcImg() {
-    ilGenImages(1, &HDRsrcImg.id);
-    ilBindImage(HDRsrcImg.id);
+void Generator::setIrradianceMethod(const IrradianceMethod method) {
+    this->irradianceMethod = method;
+    this->backend->setIrradianceMethod(method);
+}
 
-    ilLoad(IL_HDR, this->inFilePath.c_str());
+void Generator::setCostModel(CostModel* model) {
+    this->costModel = model;
+}
 
-    HDRsrcImg.width = ilGetInteger(IL_IMAGE_WIDTH);
-    HDRsrcImg.height = ilGetInteger(IL_IMAGE_HEIGHT);
-    HDRsrcImg.format = ilGetInteger(IL_IMAGE_FORMAT);
+void Generator::fitTimeBudget(const double budgetMs, const double elapsedMs, const unsigned int irradianceSize, const bool keepFaceSize) {
+    if (this->costModel == nullptr) {
+        return;
+    }
+    unsigned int size = this->getFaceSize();
+    IrradianceMethod method = this->irradianceMethod;
+    sampleSchedule::Spec spec = this->schedule;
+    bool calibrated = true;
+    double predicted = elapsedMs + this->predictMs(size, irradianceSize, method, spec, calibrated);
+    // A fixed schedule is the users choice, it only gives way to auto if auto is predicted to be cheaper
+    bool keptFixed = false;
+    auto autoIsCheaper = [&]() {
+        sampleSchedule::Spec automatic;
+        automatic.mode = sampleSchedule::Spec::Mode::Auto;
+        bool ignored = true;
+        return elapsedMs + this->predictMs(size, irradianceSize, method, automatic, ignored) < predicted;
+    };
+    // Give up quality in the order it is least visible until the prediction fits
+    while (predicted > budgetMs) {
+        if (method == IrradianceMethod::Convolution) {
+            method = IrradianceMethod::SphericalHarmonics;
+        }
+        else if (spec.mode == sampleSchedule::Spec::Mode::Full || (spec.mode == sampleSchedule::Spec::Mode::Fixed && !keptFixed && autoIsCheaper())) {
+            spec = sampleSchedule::Spec();
+            spec.mode = sampleSchedule::Spec::Mode::Auto;
+        }
+        else if (spec.mode == sampleSchedule::Spec::Mode::Fixed && !keptFixed) {
+            keptFixed = true;
+            continue;
+        }
+        else if (!keepFaceSize && size / 2 >= minBudgetFaceSize) {
+            size /= 2;
+        }
+        else {
+            break;
+        }
+        calibrated = true;
+        predicted = elapsedMs + this->predictMs(size, irradianceSize, method, spec, calibrated);
+    }
 
-    // If the image is flipped (i.e. upside-down and mirrored, flip it the right way up!)
-    ILinfo ImageInfo;
-    iluGetImageInfo(&ImageInfo);
-    if (ImageInfo.Origin == IL_ORIGIN_UPPER_LEFT)
-    {
-        iluFlipImage();
+    std::ostringstream knobs;
+    if (method != this->irradianceMethod) {
+        knobs << "irradiance convolution -> sh";
+    }
+    if (spec.mode != this->schedule.mode) {
+        knobs << (knobs.tellp() > 0 ? ", " : "") << "samples " << (this->schedule.mode == sampleSchedule::Spec::Mode::Full ? "full" : "fixed") << " -> auto";
+    }
+    else if (keptFixed) {
+        knobs << (knobs.tellp() > 0 ? ", " : "") << "samples fixed kept, auto is not predicted to be cheaper";
     }
+    if (size != this->getFaceSize()) {
+        knobs << (knobs.tellp() > 0 ? ", " : "") << "face size " << this->getFaceSize() << " -> " << size;
+    }
+    this->setIrradianceMethod(method);
+    this->setSampleSchedule(spec);
+    this->setFaceSize(size);
+    this->budgetMs = budgetMs;
+    this->predictedMs = predicted;
+
+    std::ostringstream value;
+    value << std::fixed << std::setprecision(1) << budgetMs << " ms, predicted " << predicted << " ms"
+        << (calibrated ? "" : " (partly uncalibrated)") << (predicted > budgetMs ? ", cannot be met" : "");
+    this->report.addValue("time budget", value.str());
+    this->report.addValue("time budget knobs", knobs.tellp() > 0 ? knobs.str() : "none changed");
+}
 
-    ilutRenderer(ILUT_OPENGL);
-    ilutEnable(ILUT_OPENGL_CONV);
+void Generator::reportTimeBudget(const double actualMs) {
+    if (this->budgetMs <= 0.0) {
+        return;
+    }
+    std::ostringstream value;
+    value << std::fixed << std::setprecision(1) << actualMs << " ms, predicted " << this->predictedMs << " ms, "
+        << (actualMs <= this->budgetMs ? "met" : "missed");
+    this->report.addValue("time budget actual", value.str());
+}
 
-    glGenTextures(1, &HDRsrcTexture);
-    glBindTexture(GL_TEXTURE_2D, HDRsrcTexture);
-    // Specify the texture specification
-    glTexImage2D(GL_TEXTURE_2D, // Type of texture
-        0,// Pyramid level (for mip-mapping) - 0 is the top level
-        GL_RGB16F,// Internal pixel format to use. We need a floating point buffer for HDR
-        HDRsrcImg.width,// Image width
-        HDRsrcImg.height,// Image height
-        0,// Border width in pixels (can either be 1 or 0)
-        HDRsrcImg.format,// Format of image pixel data
-        GL_FLOAT,// Image data type
-        ilGetData());// The actual image data itself
+double Generator::predictMs(unsigned int size, unsigned int irradianceSize, IrradianceMethod method, const sampleSchedule::Spec& spec, bool& calibrated) const {
+    const std::string name = this->backend->getName();
+    const CostModel::Stage irradianceStage = method == IrradianceMethod::SphericalHarmonics ? CostModel::Stage::IrradianceSH : CostModel::Stage::IrradianceConvolution;
+    double saved = cubeTexels(size) + cubeTexels(irradianceSize);
+    for (unsigned int level = 0; level < this->maxMipLevels; ++level) {
+        saved += cubeTexels(std::max(size >> level, 1u));
+    }
+    const CostModel::Stage stages[4] = { CostModel::Stage::BaseCube, irradianceStage, CostModel::Stage::Prefilter, CostModel::Stage::Save };
+    const double work[4] = { cubeTexels(size), irradianceWork(method, irradianceSize, size),
+        prefilterWork(sampleSchedule::build(spec, size, this->maxMipLevels), size), saved };
+    double ms = 0.0;
+    for (unsigned int i = 0; i < 4; ++i) {
+        ms += this->costModel->predictMs(name, stages[i], work[i]);
+        calibrated = calibrated && this->costModel->isCalibrated(name, stages[i]);
+    }
+    return ms;
+}
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+void Generator::recordCost(CostModel::Stage stage, double work, double ms) const {
+    if (this->costModel != nullptr) {
+        this->costModel->record(this->backend->getName(), stage, work, ms);
+    }
+}
 
-    glGenerateMipmap(GL_TEXTURE_2D);
+void Generator::setFaceSize(const int size) {
+    this->faceSize = size > 0 ? size : 0;
+}
 
-    if (ilGetError() != IL_NO_ERROR) {
-        std::cout << "Image load error!" << std::endl;
-    }
-    else {
-        this->initCubeCapture(this->captureFBO, this->captureColorbuffer, this->captureRBO, this->HDRsrcImg.width / 4);
-    }
+unsigned int Generator::getFaceSize() const {
+    return this->faceSize != 0 ? this->faceSize : this->HDRsrcImg.width / 4;
 }
 
-void Generator::initShader() {
-    this->displayShader = Shader("./glsl/texturedPlane.vert.glsl", "./glsl/texturedPlane.frag.glsl", nullptr);
-    this->equirectangularToCubemapShader = Shader("./glsl/std.vert.glsl", "./glsl/equiToCube.frag.glsl", nullptr);
-    this->irradianceShader = Shader("./glsl/std.vert.glsl", "./glsl/diffuseIBL.frag.glsl", nullptr);
-    this->prefilterEnvironmentShader = Shader("./glsl/std.vert.glsl", "./glsl/prefilterEnvIBL.frag.glsl", nullptr);
-    this->skyboxShader = Shader("./glsl/simpleSkyBox.vert.glsl", "./glsl/simpleSkyBox.frag.glsl", nullptr);
+void Generator::reportMemory() {
+    this->report.addValue("job arena", "peak " + Report::formatBytes(this->arena->getPeakBytes()) + ", total " + Report::formatBytes(this->arena->getTotalBytes())
+        + ", reserved " + Report::formatBytes(this->arena->getReservedBytes()));
+    this->report.addValue("scratch arenas", "peak " + Report::formatBytes(Arena::getScratchPeakBytes()) + " per thread, total " + Report::formatBytes(Arena::getScratchTotalBytes()));
+    // The process peak includes the previous jobs of a batch
+    this->report.addValue("host peak", Report::formatBytes(memoryStats::peakRss()) + (this->lowMemory ? " (low memory)" : ""));
+    this->backend->reportResources();
 }
 
-void Generator::initCubeCapture(unsigned int &fbo, unsigned int &cubeTexture, unsigned int &rbo, int sideWidth) {
-    // create a new Framebuffer
-    glGenFramebuffers(1, &fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-    // create a color attachment texture
-    glGenTextures(1, &cubeTexture);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, cubeTexture);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    for (unsigned int i = 0; i < 6; ++i)
-    {
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, sideWidth, sideWidth, 0, GL_RGB, GL_FLOAT, NULL);
-    }
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    // create a renderbuffer object (we won't be sampling these)
-    glGenRenderbuffers(1, &rbo);
-    glBindRenderbuffer(GL_RENDERBUFFER, rbo);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGB, sideWidth, sideWidth);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_RENDERBUFFER, rbo);
-    // now that we actually created the framebuffer and added all attachments we want to check if it is actually complete now
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
-    // return to default framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+Report& Generator::getReport() {
+    return this->report;
 }
 
-void Generator::renderDisplay() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    this->displayShader.use();
-    glViewport(0, 0, SRC_WIDTH, SRC_HEIGHT);
-    glBindTexture(GL_TEXTURE_2D, this->HDRsrcTexture);
-    renderQuad();
-    glfwSwapBuffers(this->window);
+void Generator::attachThread() {
+    this->backend->attachThread();
 }
 
-void Generator::renderSkybox() {
+void Generator::detachThread() {
+    this->backend->detachThread();
+}
 
-    this->skyboxShader.use();
-    skyboxShader.setInt("environmentMap", 0);
-    skyboxShader.setMat4("projection", captureProjection);
-    skyboxShader.setMat4("view", captureViews[5]);
+Backend* Generator::getBackend() const {
+    return this->backend.get();
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, captureColorbuffer);
+void Generator::saveCubeMap() const {
+    saveCubeImages(Product::Background, "background_" + this->outFileName);
+}
 
-    renderCube();
-    glfwSwapBuffers(this->window);
+void Generator::saveIrradianceMap() const {
+    saveCubeImages(Product::Irradiance, "irradiance_" + this->outFileName, "irradiance");
 }
 
-void Generator::generateCubeMap() {
-    this->equirectangularToCubemapShader.use();
-    this->equirectangularToCubemapShader.setInt("equirectangularMap", 0);
-    this->equirectangularToCubemapShader.setMat4("projection", captureProjection);
+void Generator::savePrefilteredEnvMap() const {
+    Timer timer;
+    double texels = 0.0;
+    for (unsigned int j = 0; j < this->maxMipLevels; j++) {
+        texels += cubeTexels(this->backend->getSize(Product::Prefiltered, j));
+    }
+    for (int i = 0; i < 6; i++) {
+        for (unsigned int j = 0; j < this->maxMipLevels; j++) {
+            std::string fileName = this->outPath + "/env" + "/environment_" + this->outFileName + "_" + std::to_string(j) + "_" + std::to_string(i) + ".hdr";
+            this->saveFace(Product::Prefiltered, i, j, fileName);
+        }
+    }
+    this->recordCost(CostModel::Stage::Save, texels, timer.elapsedMs());
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, HDRsrcTexture);
+std::ostream& operator<<(std::ostream& output, const Generator& gen) {
+    output << gen.inFilePath << std::endl;
+    output << gen.outPath << std::endl;
+    return output;
+}
 
-    const int sideWidth = this->HDRsrcImg.width / 4;
+void Generator::loadSrcImg() {
+    const ArenaScope scope(*this->arena);
+    HdrReader reader(this->inFilePath);
+    HDRsrcImg.width = reader.getWidth();
+    HDRsrcImg.height = reader.getHeight();
+    // A job without source would run on with a face size of 0, so it fails here
+    if (HDRsrcImg.width == 0 || HDRsrcImg.height == 0) {
+        std::cout << "ERROR: Empty hdr file: " << this->inFilePath << std::endl;
+        throw(2);
+    }
+
+    // The file starts with the top row, the backends take the bottom row first
+    const std::size_t rowFloats = std::size_t(HDRsrcImg.width) * 3;
+    float* rgb = (float*)this->arena->allocate(rowFloats * HDRsrcImg.height * sizeof(float));
+    for (unsigned int y = HDRsrcImg.height; y-- > 0;) {
+        if (!reader.readScanline(rgb + y * rowFloats)) {
+            std::cout << "ERROR: Could not read: " << this->inFilePath << std::endl;
+            throw(2);
+        }
+    }
+    // The backend keeps its own copy
+    this->backend->uploadSource(rgb, HDRsrcImg.width, HDRsrcImg.height);
+}
 
-    captureCubeFaces(sideWidth, this->captureFBO, this->captureColorbuffer, this->equirectangularToCubemapShader);
-    // then generate mipmaps
-    glBindTexture(GL_TEXTURE_CUBE_MAP, this->captureColorbuffer);
-    glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+void Generator::generateCubeMap() {
+    Timer timer;
+    this->backend->makeBaseCube(this->getFaceSize());
+    this->backend->finish();
+    this->report.addTiming(this->backend->getName() + " base cube", timer.elapsedMs());
+    this->recordCost(CostModel::Stage::BaseCube, cubeTexels(this->getFaceSize()), timer.elapsedMs());
+    this->endStage();
 }
 
-void Generator::generateEnvironmentMap() {
-    const int sideWidth = this->HDRsrcImg.width / 4;
+void Generator::generateEnvironmentMap(const bool releaseBackground) {
+    const std::vector<unsigned int> counts = sampleSchedule::build(this->schedule, this->getFaceSize(), this->maxMipLevels);
+    this->report.addValue("prefilter samples per level", sampleSchedule::describe(counts));
+    // The reference stays in the job arena until the errors are reported
+    const ArenaScope scope(*this->arena);
+    std::vector<float*> reference;
+    if (this->sampleErrorReport && this->schedule.mode != sampleSchedule::Spec::Mode::Full) {
+        Timer timer;
+        this->backend->setSampleCounts(std::vector<unsigned int>());
+        this->backend->makePrefilteredChain(this->maxMipLevels, false);
+        this->backend->finish();
+        this->report.addTiming(this->backend->getName() + " reference prefiltered chain", timer.elapsedMs());
+        reference = this->readBackPrefiltered();
+    }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-    glGenTextures(1, &this->environmentColorbuffer);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, environmentColorbuffer);
-    for (unsigned int i = 0; i < 6; ++i)
-    {
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, sideWidth, sideWidth, 0, GL_RGB, GL_FLOAT, nullptr);
+    Timer timer;
+    this->backend->setSampleCounts(counts);
+    this->backend->makePrefilteredChain(this->maxMipLevels, releaseBackground);
+    this->backend->finish();
+    this->report.addTiming(this->backend->getName() + " prefiltered chain", timer.elapsedMs());
+    this->recordCost(CostModel::Stage::Prefilter, prefilterWork(counts, this->getFaceSize()), timer.elapsedMs());
+    if (!reference.empty()) {
+        this->reportSampleError(reference);
     }
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    this->endStage();
+}
 
-    glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+std::vector<float*> Generator::readBackPrefiltered() {
+    std::vector<float*> levels;
+    for (unsigned int level = 0; this->backend->getSize(Product::Prefiltered, level) > 0; ++level) {
+        const unsigned int size = this->backend->getSize(Product::Prefiltered, level);
+        for (unsigned int face = 0; face < 6; ++face) {
+            float* rgb = (float*)this->arena->allocate(std::size_t(size) * size * 3 * sizeof(float));
+            this->backend->readBackLevel(Product::Prefiltered, face, level, rgb);
+            levels.push_back(rgb);
+        }
+    }
+    return levels;
+}
 
-    for (unsigned int mip = 0; mip < this->maxMipLevels; ++mip)
-    {
-        // reisze framebuffer according to mip-level size.
-        unsigned int mipWidth = sideWidth * std::pow(0.5, mip);
-        unsigned int mipHeight = sideWidth * std::pow(0.5, mip);
-        glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGB, mipWidth, mipHeight);
-
-        float roughness = (float)mip / (float)(this->maxMipLevels - 1);
-        prefilterEnvironmentShader.setFloat("roughness", roughness);
-        for (unsigned int i = 0; i < 6; ++i)
-        {
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, environmentColorbuffer, mip);
-
-            glViewport(0, 0, mipWidth, mipHeight);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-            this->prefilterEnvironmentShader.use();
-            this->prefilterEnvironmentShader.setInt("equirectangularMap", 0);
-            this->prefilterEnvironmentShader.setFloat("resolution", float(this->HDRsrcImg.width / 4));
-            this->prefilterEnvironmentShader.setMat4("projection", captureProjection);
-            prefilterEnvironmentShader.setMat4("view", captureViews[i]);
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, captureColorbuffer);
-
-            renderCube();
+void Generator::reportSampleError(const std::vector<float*>& reference) {
+    const ArenaScope scope(*this->arena);
+    const std::vector<float*> levels = this->readBackPrefiltered();
+    for (unsigned int level = 0; level * 6 < std::min(levels.size(), reference.size()); ++level) {
+        const std::size_t floats = std::size_t(this->backend->getSize(Product::Prefiltered, level)) * this->backend->getSize(Product::Prefiltered, level) * 3;
+        double squaredError = 0.0;
+        double squaredReference = 0.0;
+        double maxError = 0.0;
+        double maxReference = 0.0;
+        for (unsigned int face = 0; face < 6; ++face) {
+            const float* expected = reference[level * 6 + face];
+            const float* actual = levels[level * 6 + face];
+            for (std::size_t i = 0; i < floats; ++i) {
+                const double error = std::abs(double(actual[i]) - double(expected[i]));
+                squaredError += error * error;
+                squaredReference += double(expected[i]) * expected[i];
+                maxError = std::max(maxError, error);
+                maxReference = std::max(maxReference, std::abs(double(expected[i])));
+            }
         }
+        std::ostringstream key;
+        key << "prefilter level " << level << " error vs " << sampleSchedule::fullSamples << " samples";
+        std::ostringstream value;
+        value << std::fixed << std::setprecision(3) << "rms " << (squaredReference > 0.0 ? 100.0 * std::sqrt(squaredError / squaredReference) : 0.0)
+            << "%, max " << (maxReference > 0.0 ? 100.0 * maxError / maxReference : 0.0) << "%";
+        this->report.addValue(key.str(), value.str());
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void Generator::generateIrradianceMap(const int sideWidth) {
-    initCubeCapture(this->irradianceFBO, this->irradianceColorbuffer, this->irradianceRBO, sideWidth);
+void Generator::generatePreview(const unsigned int size, const unsigned int sampleCount, const int irradianceSize) {
+    // Puts the knobs of the job back also if a stage throws, a served generator runs the next job with them
+    struct KnobRestore {
+        Generator& generator;
+        const unsigned int faceSize;
+        const IrradianceMethod irradianceMethod;
+        const sampleSchedule::Spec schedule;
+        const bool sampleErrorReport;
+        ~KnobRestore() {
+            this->generator.backend->setKeepSource(false);
+            this->generator.setSampleErrorReport(this->sampleErrorReport);
+            this->generator.setSampleSchedule(this->schedule);
+            this->generator.setIrradianceMethod(this->irradianceMethod);
+            this->generator.faceSize = this->faceSize;
+        }
+    };
+    const KnobRestore restore = { *this, this->faceSize, this->irradianceMethod, this->schedule, this->sampleErrorReport };
+    sampleSchedule::Spec previewSchedule;
+    previewSchedule.mode = sampleSchedule::Spec::Mode::Fixed;
+    previewSchedule.counts.push_back(sampleCount);
+    this->setFaceSize(std::min(size, this->getFaceSize()));
+    this->setIrradianceMethod(IrradianceMethod::SphericalHarmonics);
+    this->setSampleSchedule(previewSchedule);
+    this->setSampleErrorReport(false);
+    this->backend->setKeepSource(true);
+
+    this->generateCubeMap();
+    this->saveCubeMap();
+    this->generateIrradianceMap(irradianceSize);
+    this->saveIrradianceMap();
+    this->generateEnvironmentMap();
+    this->savePrefilteredEnvMap();
+}
 
-    this->irradianceShader.use();
-    this->irradianceShader.setInt("environmentMap", 0);
-    this->irradianceShader.setMat4("projection", this->captureProjection);
+void Generator::releaseProduct(Product product) {
+    this->backend->releaseProduct(product);
+}
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, this->captureColorbuffer);
+void Generator::endStage() {
+    if (!this->lowMemory) {
+        return;
+    }
+    // Nothing of the job arena is in use between the stages
+    this->arena->trim();
+    FaceTables::releaseCache();
+}
 
-    captureCubeFaces(sideWidth, this->irradianceFBO, this->irradianceColorbuffer, this->irradianceShader);
+void Generator::generateLadderTier(const int size) {
+    // Halve step by step, a single bilinear blit over more than a factor of two would alias
+    while (this->getFaceSize() > 2 * (unsigned int)size) {
+        this->downsampleProducts(this->getFaceSize() / 2);
+    }
+    if (this->getFaceSize() > (unsigned int)size) {
+        this->downsampleProducts(size);
+    }
 }
 
-void Generator::captureCubeFaces(const int sideWidth, const unsigned int fbo, const unsigned int cubeTexture, Shader shader) {
-    //Before drawing
-    glViewport(0, 0, sideWidth, sideWidth);
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-    // render
-    for (int i = 0; i < 6; ++i)
-    {
-        shader.setMat4("view", captureViews[i]);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, cubeTexture, 0);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+void Generator::downsampleProducts(const int sideWidth) {
+    this->backend->downsampleProducts(sideWidth);
+    this->faceSize = sideWidth;
+    this->endStage();
+}
 
-        renderCube();
-    }
+void Generator::generateIrradianceMap(const int sideWidth) {
+    Timer timer;
+    this->backend->makeIrradiance(sideWidth);
+    this->backend->finish();
+    this->report.addTiming(this->backend->getName() + " irradiance", timer.elapsedMs());
+    this->recordCost(this->irradianceMethod == IrradianceMethod::SphericalHarmonics ? CostModel::Stage::IrradianceSH : CostModel::Stage::IrradianceConvolution,
+        irradianceWork(this->irradianceMethod, sideWidth, this->getFaceSize()), timer.elapsedMs());
+    this->endStage();
 }
 
-// renderCube() renders a 1x1 3D cube in NDC.
-void Generator::renderCube() {
-    // initialize (if necessary)
-    if (this->cubeVAO == 0)
-    {
-        glGenVertexArrays(1, &this->cubeVAO);
-        glGenBuffers(1, &this->cubeVBO);
-        // fill buffer
-        glBindBuffer(GL_ARRAY_BUFFER, this->cubeVBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
-        // link vertex attributes
-        glBindVertexArray(this->cubeVAO);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-    }
-    // render Cube
-    glBindVertexArray(this->cubeVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
-}
-
-// renderQuad() renders a 1x1 XY quad in NDC
-void Generator::renderQuad() {
-    if (quadVAO == 0)
-    {
-        // setup plane VAO
-        glGenVertexArrays(1, &quadVAO);
-        glGenBuffers(1, &quadVBO);
-        glBindVertexArray(quadVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
-        // Define positions location
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-        // Define uv location
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    }
-    glBindVertexArray(quadVAO);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glBindVertexArray(0);
-}
-
-void Generator::saveCubeImages(const GLuint texId, const std::string name, const std::string subDir) const {
+void Generator::saveCubeImages(Product product, const std::string name, const std::string subDir) const {
+    Timer timer;
     for (int i = 0; i < 6; ++i) {
-        GLint width, height, internalFormat;
         std::string fileName = this->outPath + "/" + subDir + "/" + name + "_" + std::to_string(i) + ".hdr";
-
-        glBindTexture(GL_TEXTURE_CUBE_MAP, texId);
-        glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat); // get internal format type of GL texture
-        glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_TEXTURE_WIDTH, &width); // get width of GL texture
-        glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_TEXTURE_HEIGHT, &height); // get height of GL texture
-
-        if (internalFormat == GL_RGB16F)
-        {
-            auto size = width * height * 3;
-            auto buffer = new float[size];
-            glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, GL_FLOAT, buffer);
-
-            // Save to an Image
-            ILuint imageID = 0;
-            ilGenImages(1, &imageID);
-            ilBindImage(imageID);
-            ilTexImage(width, height, 0, 3, IL_RGB, IL_FLOAT, buffer);
-            iluFlipImage();
-            ilSave(IL_HDR, fileName.c_str());
-
-            delete[] buffer;
-        } else {
-            std::cout << "ERROR: No HDR Image. Format: " << std::to_string(internalFormat) << std::endl;
-        }
+        this->saveFace(product, i, 0, fileName);
     }
+    this->recordCost(CostModel::Stage::Save, cubeTexels(this->backend->getSize(product, 0)), timer.elapsedMs());
 }
 
-// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-void Generator::processWindowInput() const {
-    if (glfwGetKey(this->window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(this->window, true);
-}
+void Generator::saveFace(Product product, unsigned int face, unsigned int level, const std::string& fileName) const {
+    const unsigned int size = this->backend->getSize(product, level);
+    if (size == 0) {
+        return;
+    }
+    // Every face reuses the memory of the previous one
+    const ArenaScope scope(*this->arena);
+    const std::size_t rowFloats = std::size_t(size) * 3;
+    float* rgb = (float*)this->arena->allocate(rowFloats * size * sizeof(float));
+    if (!this->backend->readBackLevel(product, face, level, rgb)) {
+        return;
+    }
 
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
-void window_size_callback(GLFWwindow* window, int width, int height)
-{
-    // make sure the viewport matches the new window dimensions; note that width and 
-    // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
+    // The backends return the bottom row first, the file starts with the top row
+    HdrWriter writer(fileName, size, size);
+    for (unsigned int y = size; y-- > 0;) {
+        writer.writeScanline(rgb + y * rowFloats);
+    }
+    writer.commit();
 }
@@ -3,25 +3,22 @@
 
 // Include standard libraries
 #include <iostream>
+#include <memory>
 #include <string>
-// Include glad for OpenGL function pointers
-#include "glad/glad.h"
-// Include GLFW for window context. OpenGL does not work without...
-#include "GLFW/glfw3.h"
-// Include glm for vector and matrix operations
-#include "glm/glm.hpp"
-#include "glm/gtc/matrix_transform.hpp"
-// Include shader class from https://learnopengl.com
-#include "learnogl/shader.h"
+#include <vector>
+// Include own classes
+#include "./arena.h"
+#include "./backend.h"
+#include "./costModel.h"
+#include "./report.h"
+#include "./sampleSchedule.h"
 
 /**
 * A helper structure just to keep things simpler.
 **/
 struct Image {
-    unsigned int id;
     unsigned int width;
     unsigned int height;
-    unsigned int format;
 };
 
 /**
@@ -33,11 +30,12 @@ struct Image {
 * It converts the equirectangular image into six images to usa as cubemap side images. It also creates a diffuse IBL Map and
 * specular maps to use in pbr shaders.
 *
-* While programming I used a lot of code originally from https://learnopengl.com. Thanks to the author :-)
+* The Generator runs the pipeline and does the file IO, the image processing itself is done by a Backend which is
+* selected by name at runtime. See GLBackend and CpuBackend.
 *
-* To initialize the OpenGL environment the glad library is used.
-* For image IO the Developer Image Library is used.
-* Since OpenGL does not work without any window context and for debuging purposes I use the GLFW library.
+* The .hdr files are read and written with HdrReader and HdrWriter. All transient buffers of a job, from the
+* decoded source to the face being saved, are taken from a job Arena. Kernels running on several threads use the
+* scratch arenas of their threads.
 **/
 class Generator {
 public:
@@ -53,13 +51,24 @@ public:
     /**
     * \brief Two parameter constructor
     *
-    * This constructor initializes all variables and the OpenGL context.
+    * This constructor initializes all variables and the backend.
     * It also calls the intern image load function.
     *
     * \param std::string& The input images path
     * \param std::string& The path where to store the output
+    * \param std::string& The name of the backend, see Backend::create
+    * \param Arena* arena The job arena. It is reset, so the memory of a previous job is reused. If not set the
+    * Generator uses an arena of its own.
     **/
-    Generator(const std::string&, const std::string&);
+    Generator(const std::string&, const std::string&, const std::string& backend = "gl", Arena* arena = nullptr);
+    /**
+    * Creates the backend without a job, so it can be kept warm for many jobs. Every job starts with loadSource
+    * and setOutPath.
+    *
+    * \param std::string& The name of the backend, see Backend::create
+    * \param Arena* arena The job arena, see the two parameter constructor
+    **/
+    Generator(const std::string& backend, Arena* arena);
     /**
     * \brief Destructor
     *
@@ -67,6 +76,13 @@ public:
     **/
     ~Generator();
     /**
+    * Starts a job: checks and loads the .hdr source and hands it to the backend. The job arena is reset, so the
+    * memory of a previous job is reused.
+    *
+    * \param std::string& The input images path
+    **/
+    void loadSource(const std::string&);
+    /**
     * Sets and creates the output directories.
     **/
     void setOutPath(const std::string&);
@@ -74,6 +90,22 @@ public:
     *
     **/
     void setMaxMipLevels(const int mips);
+    /**
+    * Builds the mip chain of the background cube with the seam aware CPU filter instead of glGenerateMipmap.
+    * The prefiltered maps sample this chain. The cpu backend always uses it.
+    **/
+    void setCpuMipmaps(const bool enable);
+    /**
+    * Sets the approximation of atan2 and asin for the direction to UV mapping of the cpu backend. The gl backend
+    * uses the functions of the shader.
+    **/
+    void setMathPrecision(const fastMath::Precision precision);
+    /**
+    * Sets the side width of the background and prefiltered cubes. 0 uses a quarter of the source width.
+    **/
+    void setFaceSize(const int size);
+    /// The side width of the background and prefiltered cubes.
+    unsigned int getFaceSize() const;
 
     /**
     * Converts a eqirectangular environment texture to a cube texture.
@@ -89,106 +121,181 @@ public:
     * Before use generateCubeMap has to be called to generate the cube texture.
     *
     * Generates a set of prefiltered images using the Hammersly algorithm.
+    *
+    * \param bool releaseBackground Frees the background cube during the stage. Only if it is saved already and no
+    * ladder tier is derived from it.
+    **/
+    void generateEnvironmentMap(const bool releaseBackground = false);
+    /**
+    * Generates and saves all products at a reduced quality, replacing the files of a previous pass. The source is
+    * kept, so the next pass or the full pipeline can follow. The irradiance map is always evaluated from spherical
+    * harmonics, the other knobs are restored afterwards.
+    *
+    * \param const unsigned int size The face size of the pass, at most the one of the full pipeline
+    * \param const unsigned int sampleCount The GGX samples of every prefiltered level
+    * \param const int irradianceSize The side width of the irradiance map
     **/
-    void generateEnvironmentMap();
+    void generatePreview(const unsigned int size, const unsigned int sampleCount, const int irradianceSize);
+    /**
+    * Before use generateCubeMap and generateEnvironmentMap have to be called.
+    *
+    * Derives a smaller resolution tier from the current background and prefiltered cubes by filtered
+    * downsampling instead of running the pipeline again. The tier replaces the current cubes, so the
+    * save functions write it afterwards. The irradiance map does not depend on the face size and is kept.
+    *
+    * \param const int size The new side width. Has to be smaller than the current one.
+    **/
+    void generateLadderTier(const int size);
     /// Save the background texture
     void saveCubeMap() const;
     /// Save the irradiance texture
     void saveIrradianceMap() const;
     /// Save the environment texture
     void savePrefilteredEnvMap() const;
+    /// Frees a product after its last use. It is not saved anymore.
+    void releaseProduct(Product product);
+    /**
+    * Gives up caches between the stages: the free chunks of the job arena, the face tables and the pooled
+    * textures of the gl backend. Stages run slower, the peak memory is lower.
+    **/
+    void setLowMemory(const bool enable);
+    /**
+    * Renders every prefiltered level of the gl backend with the generic shader as well, so the report shows the
+    * gain of the variant specialized for the level.
+    **/
+    void setCompareShaderVariants(const bool enable);
+    /**
+    * Sets the number of GGX samples per prefiltered level. The default is sampleSchedule::fullSamples everywhere.
+    **/
+    void setSampleSchedule(const sampleSchedule::Spec& schedule);
+    /**
+    * Prefilters with the full sample count first and reports the error of every level of the schedule against it.
+    * Costs a second prefilter pass and a copy of the reference in the job arena. Nothing is done for the full schedule.
+    **/
+    void setSampleErrorReport(const bool enable);
+    /// Sets how the irradiance map is computed. The default is the convolution of diffuseIBL.frag.glsl.
+    void setIrradianceMethod(const IrradianceMethod method);
+    /**
+    * Records the work and the time of every stage in a cost model, which fitTimeBudget predicts with.
+    *
+    * \param CostModel* model The model, it has to outlive the Generator. nullptr records nothing.
+    **/
+    void setCostModel(CostModel* model);
+    /**
+    * Chooses the quality knobs up front so the job is predicted to finish within a time budget. Knobs are given up
+    * in the order they are least visible: the irradiance method (spherical harmonics instead of the convolution),
+    * the sample schedule (auto instead of full) and then the face size, halved down to 64. A fixed schedule is given
+    * up for auto only if auto is predicted to be cheaper, otherwise it is kept and the report says so. The budget and
+    * the prediction, the changed knobs and whether the budget can be met are added to the report.
+    *
+    * \param double budgetMs The budget of the whole job
+    * \param double elapsedMs The time the job has already taken, loading the source
+    * \param unsigned int irradianceSize The side width of the irradiance map
+    * \param bool keepFaceSize Do not change the face size, e.g. for a ladder
+    **/
+    void fitTimeBudget(const double budgetMs, const double elapsedMs, const unsigned int irradianceSize, const bool keepFaceSize);
+    /// Adds the actual time of the job next to the prediction of fitTimeBudget to the report, if it was called.
+    void reportTimeBudget(const double actualMs);
+
+    /// Adds the peak and the total bytes of the job arena and the scratch arenas, the peak of the process and the resources of the backend to the report.
+    void reportMemory();
 
-    /// Debug function
-    GLFWwindow* getWindow() const;
-    /// Debug function
-    void renderDisplay();
-    /// Debug function
-    void renderSkybox();
+    /**
+    * Binds the generator to the calling thread, see Backend::attachThread. Generators on different threads run in
+    * parallel, every one has its own backend, arena and report.
+    **/
+    void attachThread();
+    /// Releases the calling thread, so another one can attach.
+    void detachThread();
 
-    /// Glfw callback function
-    void processWindowInput() const;
+    /// The timings and measurements collected so far.
+    Report& getReport();
+    /// The backend doing the image processing.
+    Backend* getBackend() const;
 
 private:
-    /// Windows width
-    const unsigned int SRC_WIDTH = 800;
-    /// Windows height
-    const unsigned int SRC_HEIGHT = 600;
     /// The equirectangular .hdr source file.
     std::string inFilePath;
     /// The path where to save to.
     std::string outPath;
     /// The filename to save as
     std::string outFileName;
-    /// For the window context.
-    GLFWwindow* window;
-    /// The eqirectangulars source images ID.
+    /// The size of the eqirectangular source.
     Image HDRsrcImg;
-    /// The different shader objects.
-    Shader displayShader, equirectangularToCubemapShader, irradianceShader, prefilterEnvironmentShader, skyboxShader;
-    /// The projection matrix used to render the cube faces, when rendering the cube textures.
-    const glm::mat4 captureProjection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 10.0f);
-
-    /// The eqirectangular texture object created from the src image.
-    unsigned int HDRsrcTexture;
-    /// The cubes vertex array object.
-    unsigned int cubeVAO = 0;
-    /// The cubes vertex buffer object bound to cubeVAO.
-    unsigned int cubeVBO = 0;
-    /// The planes vertex array object. This was used to render a simple plane to the screen for debugging.
-    unsigned int quadVAO = 0;
-    /// The quads vertex buffer object bound to quadVAO.
-    unsigned int quadVBO;
-    /// The custom framebuffer to render the different textures.
-    unsigned int captureFBO;
-    /// The textures ID where the unchanged cube faces are saved in.
-    unsigned int captureColorbuffer;
-    /// The render buffer object boud to captureFBO.
-    unsigned int captureRBO;
-    // TODO: reuse captureFBO?
-    unsigned int irradianceFBO;
-    /// The textures ID where the irradiance map is writen to.
-    unsigned int irradianceColorbuffer;
-    unsigned int irradianceRBO;
-
-    /// That is the textures ID for the prefiltered environment maps.
-    unsigned int environmentColorbuffer;
     /// This determines how many mipmaps are created and which roughness values are used for wvery one.
     unsigned int maxMipLevels = 6;
+    /// The side width of the background and prefiltered cubes. 0 is a quarter of the source width.
+    unsigned int faceSize = 0;
+    /// See setLowMemory.
+    bool lowMemory = false;
+    /// See setSampleSchedule.
+    sampleSchedule::Spec schedule;
+    /// See setSampleErrorReport.
+    bool sampleErrorReport = false;
+    /// See setIrradianceMethod.
+    IrradianceMethod irradianceMethod = IrradianceMethod::Convolution;
+    /// See setCostModel.
+    CostModel* costModel = nullptr;
+    /// The budget and the predicted time of fitTimeBudget, 0 if it was not called.
+    double budgetMs = 0.0;
+    double predictedMs = 0.0;
+    /// Collects timings and measurements for the summary.
+    Report report;
+    /// The arena if none was passed to the constructor.
+    std::unique_ptr<Arena> ownArena;
+    /// Supplies the transient buffers of the job.
+    Arena* arena;
+    /// Does the image processing. Declared after report and arena which it refers to.
+    std::unique_ptr<Backend> backend;
 
-    /// Initializes all Shader objects.
-    void initShader();
-    /// Creates the src image object.
+    /// Loads the src image and hands it to the backend.
     void loadSrcImg();
+    /// Called after every stage, gives up the caches in low memory mode.
+    void endStage();
     /**
-    * Initializes a framebuffer object and a texture object without mipmaps to write the render results to.
+    * Reads back all prefiltered levels.
     *
-    * \param unsigned int &fbo Stores the newly crated framebuffers ID.
-    * \param unsigned int &cubeTexture Stores the newly crated textures ID.
-    * \param unsigned int &rbo Stores the newly crated rbo ID. TODO!
-    * \param int sideWidth The cubes side with and height. This will become the textures dimensions.
+    * \return The face levels in level major order, taken from the job arena
     **/
-    void initCubeCapture(unsigned int &fbo, unsigned int &cubeTexture, unsigned int &rbo, int sideWidth);
-
+    std::vector<float*> readBackPrefiltered();
     /**
-    * Renders the cube faces and stores them into the given texture.
+    * Adds the rms and the maximum difference of every prefiltered level to the reference to the report, both
+    * relative to the reference level: the rms to its rms, the maximum to its brightest channel.
     *
-    * \param const int sideWidth The images dimensions
-    * \param const unsigned int fbo The framebuffers ID where to render the images to.
-    * \param const unsigned int cubeTextures The cube texture ID where to render the images to.
-    * \param Shader shader The shader object to use for the cubes faces while rendering.
+    * \param const std::vector<float*>& reference The levels from readBackPrefiltered
     **/
-    void captureCubeFaces(const int sideWidth, const unsigned int fbo, const unsigned int cubeTexture, Shader shader);
+    void reportSampleError(const std::vector<float*>& reference);
     /**
-    * Save the renderings to disk.
+    * The predicted time of all stages of a job with the given knobs.
     *
-    * \param const unsigned int texID The cubeTexture ID where the images data is.
+    * \param bool& calibrated Set to false if a stage was never measured
     **/
-    void saveCubeImages(const GLuint texID, const std::string name, const std::string subDir = "") const;
-
-    /// Helper to display a 2d texture.
-    void renderQuad();
-    /// Called every time a the cube has to be rendered to capture one of its faces.
-    void renderCube();
+    double predictMs(unsigned int size, unsigned int irradianceSize, IrradianceMethod method, const sampleSchedule::Spec& spec, bool& calibrated) const;
+    /// Records a stage in the cost model, if there is one.
+    void recordCost(CostModel::Stage stage, double work, double ms) const;
+    /**
+    * Replaces the background and prefiltered cubes by downsampled copies.
+    *
+    * \param int sideWidth The new side width. At most a factor of two smaller than the current one.
+    **/
+    void downsampleProducts(const int sideWidth);
+    /**
+    * Save one product to disk.
+    *
+    * \param Product product The product to read back from the backend
+    * \param const std::string name The file name prefix
+    * \param const std::string subDir The sub directory of the output path
+    **/
+    void saveCubeImages(Product product, const std::string name, const std::string subDir = "") const;
+    /**
+    * Save a single face level to disk.
+    *
+    * \param Product product The product to read back from the backend
+    * \param unsigned int face The face index
+    * \param unsigned int level The mip level
+    * \param const std::string& fileName The .hdr file to write
+    **/
+    void saveFace(Product product, unsigned int face, unsigned int level, const std::string& fileName) const;
 
     /// From the beginning when I checked if everything worked fine.
     friend std::ostream& operator<<(std::ostream& output, const Generator& gen);
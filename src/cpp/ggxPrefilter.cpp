@@ -0,0 +1,496 @@
+// Include own header
+#include "./ggxPrefilter.h"
+#include "./cpuFeatures.h"
+#include "./cubeFaces.h"
+#include "./faceTables.h"
+#include "./parallel.h"
+#include "./sampleSchedule.h"
+// Include standard libraries
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GGXPREFILTER_AVX2
+#if defined(_MSC_VER)
+// MSVC accepts AVX2 intrinsics without /arch:AVX2, the kernel is only called after the CPU check
+#define GGXPREFILTER_TARGET_AVX2
+#else
+#define GGXPREFILTER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+    const float PI = 3.14159265359f;
+    /// The number of tasks per thread the work is split into, enough for the stealing to even out the estimates.
+    const unsigned int tasksPerThread = 16;
+
+    /// RadicalInverse_VdC of prefilterEnvIBL.frag.glsl
+    float radicalInverse(unsigned int bits) {
+        bits = (bits << 16u) | (bits >> 16u);
+        bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+        bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+        bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+        bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+        return float(bits) * 2.3283064365386963e-10f;
+    }
+
+    /**
+    * The samples of one roughness in tangent space, structure of arrays padded to a multiple of 8 with samples
+    * of weight 0. Only samples with NdotL > 0 are stored, sorted by LOD so the lanes of a vector mostly hit the
+    * same levels.
+    **/
+    struct SampleTable {
+        std::vector<float> x, y, z, weight, lod;
+        float totalWeight = 0.0f;
+        /// The number of samples with a weight, the padding excluded.
+        std::size_t count = 0;
+    };
+
+    /**
+    * Evaluates the per sample terms of the shader once.
+    *
+    * \param float roughness The roughness of the level
+    * \param unsigned int sampleCount The number of samples, fewer samples read from blurrier source levels
+    * \param float saTexel The solid angle of a texel of the source level 0
+    * \param float implicitLod The LOD texture() derives from the screen space derivatives of the rendered level
+    **/
+    SampleTable buildTable(float roughness, unsigned int sampleCount, float saTexel, float implicitLod) {
+        struct Sample { float x, y, z, weight, lod; };
+        std::vector<Sample> samples;
+        if (roughness == 0.0f) {
+            // Every sample is the reflection itself with mipLevel 0
+            samples.push_back({ 0.0f, 0.0f, 1.0f, 1.0f, implicitLod });
+        }
+        else {
+            // Both shader functions end up with alpha^2 where alpha = roughness^2
+            const float a2 = roughness * roughness * roughness * roughness;
+            for (unsigned int i = 0; i < sampleCount; ++i) {
+                // ImportanceSampleGGX, still in tangent space where N = V = (0, 0, 1)
+                const float phi = 2.0f * PI * float(i) / float(sampleCount);
+                const float xi = radicalInverse(i);
+                const float cosTheta = std::sqrt((1.0f - xi) / (1.0f + (a2 - 1.0f) * xi));
+                const float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+                const float hx = std::cos(phi) * sinTheta;
+                const float hy = std::sin(phi) * sinTheta;
+                const float hz = cosTheta;
+                // L = reflect(-V, H)
+                float lx = 2.0f * hz * hx;
+                float ly = 2.0f * hz * hy;
+                float lz = 2.0f * hz * hz - 1.0f;
+                const float length = std::sqrt(lx * lx + ly * ly + lz * lz);
+                lx /= length;
+                ly /= length;
+                lz /= length;
+                if (lz <= 0.0f) {
+                    continue;
+                }
+                // DistributionGGX with NdotH = HdotV = hz
+                const float denom = hz * hz * (a2 - 1.0f) + 1.0f;
+                const float D = a2 / (PI * denom * denom);
+                const float pdf = (D * hz / (4.0f * hz)) + 0.0001f;
+                const float saSample = 1.0f / (float(sampleCount) * pdf + 0.0001f);
+                samples.push_back({ lx, ly, lz, lz, implicitLod + 0.5f * std::log2(saSample / saTexel) });
+            }
+        }
+        std::sort(samples.begin(), samples.end(), [](const Sample& s0, const Sample& s1) { return s0.lod < s1.lod; });
+
+        SampleTable table;
+        table.count = samples.size();
+        const std::size_t padded = (samples.size() + 7) / 8 * 8;
+        table.x.assign(padded, 0.0f);
+        table.y.assign(padded, 0.0f);
+        table.z.assign(padded, 1.0f);
+        table.weight.assign(padded, 0.0f);
+        table.lod.assign(padded, 0.0f);
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            table.x[i] = samples[i].x;
+            table.y[i] = samples[i].y;
+            table.z[i] = samples[i].z;
+            table.weight[i] = samples[i].weight;
+            table.lod[i] = samples[i].lod;
+            table.totalWeight += samples[i].weight;
+        }
+        return table;
+    }
+
+    /**
+    * All levels of a cube as planar faces with a one texel border from the neighbouring faces. Texel (x, y) of a
+    * face level is at offsets[level * 6 + face] + (y + 1) * (size + 2) + x + 1 of every plane.
+    **/
+    struct PaddedCube {
+        PlanarImage::Buffer texels { nullptr, nullptr };
+        /// Floats from one plane to the next, a multiple of 16 so every plane starts 64 byte aligned.
+        std::size_t planeStride;
+        std::vector<std::size_t> offsets;
+        /// The offsets for the 32 bit indices of the gathers, empty if a plane is too big for them.
+        std::vector<int> gatherOffsets;
+        std::vector<int> sizes;
+        int maxLevel;
+
+        PaddedCube(const CubeImage& cube, Arena& arena) {
+            const unsigned int levels = cube.getLevelCount();
+            this->maxLevel = int(levels) - 1;
+            std::size_t total = 0;
+            for (unsigned int level = 0; level < levels; ++level) {
+                const std::size_t stride = cube.getSize(level) + 2;
+                this->sizes.push_back(int(cube.getSize(level)));
+                for (unsigned int face = 0; face < 6; ++face) {
+                    this->offsets.push_back(total);
+                    total += stride * stride;
+                }
+            }
+            // Face sizes from about 16384 on pass INT_MAX floats per plane
+            if (total <= std::size_t(std::numeric_limits<int>::max())) {
+                this->gatherOffsets.assign(this->offsets.begin(), this->offsets.end());
+            }
+            // Multiple of the PlanarImage alignment without its unsigned int width
+            this->planeStride = (total + 15) / 16 * 16;
+            this->texels = arena.allocateFloats(this->planeStride * 3);
+            parallel::forEach(levels * 6, [&](unsigned int item) {
+                const unsigned int level = item / 6;
+                const unsigned int face = item % 6;
+                const int size = this->sizes[level];
+                float* dst = this->texels.get() + this->offsets[item];
+                for (int y = -1; y <= size; ++y) {
+                    for (int x = -1; x <= size; ++x) {
+                        float rgb[3];
+                        cube.getTexel(level, face, x, y, rgb);
+                        for (unsigned int c = 0; c < 3; ++c) {
+                            dst[c * this->planeStride] = rgb[c];
+                        }
+                        dst++;
+                    }
+                }
+            });
+        }
+
+        /// Bilinear lookup in one level at face coordinates in [-1, 1].
+        void sampleLevel(int level, unsigned int face, float x, float y, float* rgb) const {
+            const int size = this->sizes[level];
+            const float px = (x + 1.0f) * 0.5f * size - 0.5f;
+            const float py = (y + 1.0f) * 0.5f * size - 0.5f;
+            const float x0 = std::min(std::max(std::floor(px), -1.0f), float(size - 1));
+            const float y0 = std::min(std::max(std::floor(py), -1.0f), float(size - 1));
+            const float fx = std::min(std::max(px - x0, 0.0f), 1.0f);
+            const float fy = std::min(std::max(py - y0, 0.0f), 1.0f);
+            const int stride = size + 2;
+            const std::size_t i00 = this->offsets[level * 6 + face] + std::size_t((int(y0) + 1) * stride + int(x0) + 1);
+            for (int c = 0; c < 3; ++c) {
+                const float* t00 = this->texels.get() + c * this->planeStride + i00;
+                const float* t01 = t00 + stride;
+                const float bottom = t00[0] + (t00[1] - t00[0]) * fx;
+                const float top = t01[0] + (t01[1] - t01[0]) * fx;
+                rgb[c] = bottom + (top - bottom) * fy;
+            }
+        }
+
+        /// Copies the interior of a face level into a view of the same size.
+        void copyLevel(int level, unsigned int face, const ImageView& view) const {
+            const int size = this->sizes[level];
+            const int stride = size + 2;
+            for (int c = 0; c < 3; ++c) {
+                const float* plane = this->texels.get() + c * this->planeStride + this->offsets[level * 6 + face];
+                for (int y = 0; y < size; ++y) {
+                    for (int x = 0; x < size; ++x) {
+                        view.at(c, x, y) = plane[(y + 1) * stride + x + 1];
+                    }
+                }
+            }
+        }
+
+        /// Trilinear lookup like a seamless cube map.
+        void sample(const glm::vec3& dir, float lod, float* rgb) const {
+            float x, y;
+            const unsigned int face = cubeFaces::locate(dir, x, y);
+            lod = std::min(std::max(lod, 0.0f), float(this->maxLevel));
+            const int level = int(lod);
+            const float t = lod - level;
+            this->sampleLevel(level, face, x, y, rgb);
+            if (t > 0.0f) {
+                float next[3];
+                this->sampleLevel(level + 1, face, x, y, next);
+                for (int c = 0; c < 3; ++c) {
+                    rgb[c] += (next[c] - rgb[c]) * t;
+                }
+            }
+        }
+    };
+
+    /// The tangent frame of the shader for a normal.
+    void tangentFrame(const glm::vec3& N, glm::vec3& tangent, glm::vec3& bitangent) {
+        const glm::vec3 up = std::abs(N.z) < 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+        tangent = glm::normalize(glm::cross(up, N));
+        bitangent = glm::cross(N, tangent);
+    }
+
+    void prefilterTexelScalar(const PaddedCube& cube, const SampleTable& table, const glm::vec3& N, float* rgb) {
+        glm::vec3 tangent, bitangent;
+        tangentFrame(N, tangent, bitangent);
+        float sum[3] = { 0.0f, 0.0f, 0.0f };
+        for (std::size_t i = 0; i < table.count; ++i) {
+            const glm::vec3 L = table.x[i] * tangent + table.y[i] * bitangent + table.z[i] * N;
+            float color[3];
+            cube.sample(L, table.lod[i], color);
+            for (int c = 0; c < 3; ++c) {
+                sum[c] += color[c] * table.weight[i];
+            }
+        }
+        for (int c = 0; c < 3; ++c) {
+            rgb[c] = sum[c] / table.totalWeight;
+        }
+    }
+
+#ifdef GGXPREFILTER_AVX2
+    /// The right and up axes of the faces as rows of 8 floats, lane i belongs to face i.
+    struct FaceAxes {
+        float rows[6][8];
+
+        FaceAxes() {
+            for (unsigned int face = 0; face < 8; ++face) {
+                const glm::vec3 forward = cubeFaces::direction(face % 6, 0.0f, 0.0f);
+                const glm::vec3 right = cubeFaces::direction(face % 6, 1.0f, 0.0f) - forward;
+                const glm::vec3 up = cubeFaces::direction(face % 6, 0.0f, 1.0f) - forward;
+                this->rows[0][face] = right.x;
+                this->rows[1][face] = right.y;
+                this->rows[2][face] = right.z;
+                this->rows[3][face] = up.x;
+                this->rows[4][face] = up.y;
+                this->rows[5][face] = up.z;
+            }
+        }
+    };
+
+    /// Bilinear lookup of 8 directions, every lane in its own level and face. The cube needs gatherOffsets.
+    GGXPREFILTER_TARGET_AVX2
+    void sampleLevel8(const PaddedCube& cube, __m256i level, __m256i face, __m256 x, __m256 y, __m256& r, __m256& g, __m256& b) {
+        const __m256i sizeInt = _mm256_i32gather_epi32(cube.sizes.data(), level, 4);
+        const __m256 size = _mm256_cvtepi32_ps(sizeInt);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 px = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_add_ps(x, one), half), size), half);
+        const __m256 py = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_add_ps(y, one), half), size), half);
+        const __m256 last = _mm256_sub_ps(size, one);
+        const __m256 x0 = _mm256_min_ps(_mm256_max_ps(_mm256_floor_ps(px), _mm256_set1_ps(-1.0f)), last);
+        const __m256 y0 = _mm256_min_ps(_mm256_max_ps(_mm256_floor_ps(py), _mm256_set1_ps(-1.0f)), last);
+        const __m256 fx = _mm256_min_ps(_mm256_max_ps(_mm256_sub_ps(px, x0), _mm256_setzero_ps()), one);
+        const __m256 fy = _mm256_min_ps(_mm256_max_ps(_mm256_sub_ps(py, y0), _mm256_setzero_ps()), one);
+
+        // The same indices address all three planes
+        const __m256i one32 = _mm256_set1_epi32(1);
+        const __m256i offset = _mm256_i32gather_epi32(cube.gatherOffsets.data(), _mm256_add_epi32(_mm256_mullo_epi32(level, _mm256_set1_epi32(6)), face), 4);
+        const __m256i stride = _mm256_add_epi32(sizeInt, _mm256_set1_epi32(2));
+        const __m256i column = _mm256_add_epi32(_mm256_cvtps_epi32(x0), one32);
+        const __m256i row = _mm256_mullo_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(y0), one32), stride);
+        const __m256i i00 = _mm256_add_epi32(offset, _mm256_add_epi32(row, column));
+        const __m256i i10 = _mm256_add_epi32(i00, one32);
+        const __m256i i01 = _mm256_add_epi32(i00, stride);
+        const __m256i i11 = _mm256_add_epi32(i01, one32);
+
+        __m256* channels[3] = { &r, &g, &b };
+        for (int c = 0; c < 3; ++c) {
+            const float* base = cube.texels.get() + c * cube.planeStride;
+            const __m256 t00 = _mm256_i32gather_ps(base, i00, 4);
+            const __m256 t10 = _mm256_i32gather_ps(base, i10, 4);
+            const __m256 t01 = _mm256_i32gather_ps(base, i01, 4);
+            const __m256 t11 = _mm256_i32gather_ps(base, i11, 4);
+            const __m256 bottom = _mm256_add_ps(t00, _mm256_mul_ps(_mm256_sub_ps(t10, t00), fx));
+            const __m256 top = _mm256_add_ps(t01, _mm256_mul_ps(_mm256_sub_ps(t11, t01), fx));
+            *channels[c] = _mm256_add_ps(bottom, _mm256_mul_ps(_mm256_sub_ps(top, bottom), fy));
+        }
+    }
+
+    GGXPREFILTER_TARGET_AVX2
+    float horizontalSum(__m256 v) {
+        const __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        const __m128 sum2 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+        const __m128 sum1 = _mm_add_ss(sum2, _mm_shuffle_ps(sum2, sum2, 1));
+        return _mm_cvtss_f32(sum1);
+    }
+
+    /// Filters one texel with 8 samples at a time.
+    GGXPREFILTER_TARGET_AVX2
+    void prefilterTexelAvx2(const PaddedCube& cube, const SampleTable& table, const FaceAxes& axes, const glm::vec3& N, float* rgb) {
+        glm::vec3 tangent, bitangent;
+        tangentFrame(N, tangent, bitangent);
+        const __m256 tx = _mm256_set1_ps(tangent.x), ty = _mm256_set1_ps(tangent.y), tz = _mm256_set1_ps(tangent.z);
+        const __m256 bx = _mm256_set1_ps(bitangent.x), by = _mm256_set1_ps(bitangent.y), bz = _mm256_set1_ps(bitangent.z);
+        const __m256 nx = _mm256_set1_ps(N.x), ny = _mm256_set1_ps(N.y), nz = _mm256_set1_ps(N.z);
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        const __m256 maxLevel = _mm256_set1_ps(float(cube.maxLevel));
+        const __m256i maxLevelInt = _mm256_set1_epi32(cube.maxLevel);
+        const __m256 rightX = _mm256_loadu_ps(axes.rows[0]), rightY = _mm256_loadu_ps(axes.rows[1]), rightZ = _mm256_loadu_ps(axes.rows[2]);
+        const __m256 upX = _mm256_loadu_ps(axes.rows[3]), upY = _mm256_loadu_ps(axes.rows[4]), upZ = _mm256_loadu_ps(axes.rows[5]);
+
+        __m256 sumR = _mm256_setzero_ps(), sumG = _mm256_setzero_ps(), sumB = _mm256_setzero_ps();
+        for (std::size_t i = 0; i < table.x.size(); i += 8) {
+            const __m256 sx = _mm256_loadu_ps(&table.x[i]);
+            const __m256 sy = _mm256_loadu_ps(&table.y[i]);
+            const __m256 sz = _mm256_loadu_ps(&table.z[i]);
+            // Rotate the samples into the tangent frame of the texel
+            const __m256 dx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, tx), _mm256_mul_ps(sy, bx)), _mm256_mul_ps(sz, nx));
+            const __m256 dy = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, ty), _mm256_mul_ps(sy, by)), _mm256_mul_ps(sz, ny));
+            const __m256 dz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, tz), _mm256_mul_ps(sy, bz)), _mm256_mul_ps(sz, nz));
+
+            // The major axis selects the face, +X -X +Y -Y +Z -Z
+            const __m256 ax = _mm256_andnot_ps(signMask, dx);
+            const __m256 ay = _mm256_andnot_ps(signMask, dy);
+            const __m256 az = _mm256_andnot_ps(signMask, dz);
+            const __m256 xMajor = _mm256_and_ps(_mm256_cmp_ps(ax, ay, _CMP_GE_OQ), _mm256_cmp_ps(ax, az, _CMP_GE_OQ));
+            const __m256 yMajor = _mm256_andnot_ps(xMajor, _mm256_cmp_ps(ay, az, _CMP_GE_OQ));
+            const __m256 best = _mm256_blendv_ps(_mm256_blendv_ps(az, ay, yMajor), ax, xMajor);
+            const __m256 major = _mm256_blendv_ps(_mm256_blendv_ps(dz, dy, yMajor), dx, xMajor);
+            __m256i face = _mm256_castps_si256(_mm256_blendv_ps(_mm256_blendv_ps(
+                _mm256_castsi256_ps(_mm256_set1_epi32(4)), _mm256_castsi256_ps(_mm256_set1_epi32(2)), yMajor),
+                _mm256_castsi256_ps(_mm256_setzero_si256()), xMajor));
+            face = _mm256_sub_epi32(face, _mm256_castps_si256(_mm256_cmp_ps(major, _mm256_setzero_ps(), _CMP_LT_OQ)));
+
+            const __m256 invBest = _mm256_div_ps(_mm256_set1_ps(1.0f), best);
+            const __m256 fx = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(
+                _mm256_mul_ps(dx, _mm256_permutevar8x32_ps(rightX, face)),
+                _mm256_mul_ps(dy, _mm256_permutevar8x32_ps(rightY, face))),
+                _mm256_mul_ps(dz, _mm256_permutevar8x32_ps(rightZ, face))), invBest);
+            const __m256 fy = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(
+                _mm256_mul_ps(dx, _mm256_permutevar8x32_ps(upX, face)),
+                _mm256_mul_ps(dy, _mm256_permutevar8x32_ps(upY, face))),
+                _mm256_mul_ps(dz, _mm256_permutevar8x32_ps(upZ, face))), invBest);
+
+            // Trilinear between the two nearest levels
+            const __m256 lod = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(&table.lod[i]), _mm256_setzero_ps()), maxLevel);
+            const __m256 level0 = _mm256_floor_ps(lod);
+            const __m256 t = _mm256_sub_ps(lod, level0);
+            const __m256i level0Int = _mm256_cvtps_epi32(level0);
+            const __m256i level1Int = _mm256_min_epi32(_mm256_add_epi32(level0Int, _mm256_set1_epi32(1)), maxLevelInt);
+            __m256 r0, g0, b0, r1, g1, b1;
+            sampleLevel8(cube, level0Int, face, fx, fy, r0, g0, b0);
+            sampleLevel8(cube, level1Int, face, fx, fy, r1, g1, b1);
+
+            const __m256 weight = _mm256_loadu_ps(&table.weight[i]);
+            sumR = _mm256_add_ps(sumR, _mm256_mul_ps(_mm256_add_ps(r0, _mm256_mul_ps(_mm256_sub_ps(r1, r0), t)), weight));
+            sumG = _mm256_add_ps(sumG, _mm256_mul_ps(_mm256_add_ps(g0, _mm256_mul_ps(_mm256_sub_ps(g1, g0), t)), weight));
+            sumB = _mm256_add_ps(sumB, _mm256_mul_ps(_mm256_add_ps(b0, _mm256_mul_ps(_mm256_sub_ps(b1, b0), t)), weight));
+        }
+        rgb[0] = horizontalSum(sumR) / table.totalWeight;
+        rgb[1] = horizontalSum(sumG) / table.totalWeight;
+        rgb[2] = horizontalSum(sumB) / table.totalWeight;
+    }
+#endif
+}
+
+CubeImage ggxPrefilter::prefilter(CubeImage& source, unsigned int levels, const std::vector<unsigned int>& sampleCounts, bool releaseSource, TaskScheduler& scheduler, Report& report, Arena& arena) {
+    Timer total;
+    const ArenaScope scope(arena);
+    const unsigned int faceSize = source.getSize();
+    const PaddedCube cube(source, arena);
+    report.addTiming("prefilter source padding", total.elapsedMs());
+    // The padded copy is all the kernels read
+    if (releaseSource) {
+        source = CubeImage();
+    }
+    CubeImage target(faceSize, levels);
+
+    // The gathers take 32 bit indices, bigger cubes take the scalar kernel
+    const bool addressable = !cube.gatherOffsets.empty();
+    const bool avx2 = cpuFeatures::hasAvx2() && addressable;
+#ifdef GGXPREFILTER_AVX2
+    const FaceAxes axes;
+#endif
+    report.addValue("prefilter kernel", avx2 ? "avx2 8 wide" : addressable ? "scalar" : "scalar (cube too big for the avx2 gathers)");
+
+    // resolution is the side width of the source cube
+    const float saTexel = 4.0f * PI / (6.0f * faceSize * faceSize);
+    std::vector<SampleTable> tables;
+    double totalCost = 0.0;
+    for (unsigned int mip = 0; mip < levels; ++mip) {
+        const unsigned int size = target.getSize(mip);
+        const float roughness = levels > 1 ? float(mip) / float(levels - 1) : 0.0f;
+        // texture() adds the mip level of the shader as a bias to the implicit LOD of the rendered level
+        const unsigned int sampleCount = mip < sampleCounts.size() ? sampleCounts[mip] : sampleSchedule::fullSamples;
+        tables.push_back(buildTable(roughness, sampleCount, saTexel, std::log2(float(faceSize) / size)));
+        if (roughness == 0.0f && size == faceSize) {
+            // One sample at LOD 0 in the texel center is the source texel, copied below instead
+            tables.back().count = 0;
+            continue;
+        }
+        totalCost += double(tables.back().count) * size * size * 6;
+    }
+
+    // All levels are scheduled at once. A task costs about totalCost / (threads * tasksPerThread) samples,
+    // so the cheap levels become few big tiles and the expensive ones many small tiles.
+    const double taskCost = totalCost / (scheduler.getThreadCount() * tasksPerThread);
+    std::vector<std::atomic<long long>> levelMicroseconds(levels);
+    std::vector<TaskScheduler::Task> tasks;
+    for (unsigned int mip = 0; mip < levels; ++mip) {
+        const unsigned int size = target.getSize(mip);
+        const SampleTable& table = tables[mip];
+        levelMicroseconds[mip] = 0;
+        if (table.count == 0) {
+            Timer timer;
+            for (unsigned int face = 0; face < 6; ++face) {
+                cube.copyLevel(0, face, target.getFace(mip, face));
+            }
+            levelMicroseconds[mip] += (long long)(timer.elapsedMs() * 1000.0);
+            continue;
+        }
+        const std::shared_ptr<const FaceTables> directions = FaceTables::get(size, report);
+        const double texelsPerTask = std::max(taskCost / table.count, 1.0);
+        const unsigned int tile = std::min(std::max((unsigned int)std::sqrt(texelsPerTask), 1u), size);
+        for (unsigned int face = 0; face < 6; ++face) {
+            for (unsigned int y0 = 0; y0 < size; y0 += tile) {
+                for (unsigned int x0 = 0; x0 < size; x0 += tile) {
+                    const unsigned int x1 = std::min(x0 + tile, size);
+                    const unsigned int y1 = std::min(y0 + tile, size);
+                    TaskScheduler::Task task;
+                    task.cost = double(table.count) * (x1 - x0) * (y1 - y0);
+                    task.work = [&, directions, mip, size, face, x0, y0, x1, y1]() {
+                        Timer timer;
+                        const SampleTable& table = tables[mip];
+                        const ImageView pixels = target.getFace(mip, face);
+                        for (unsigned int y = y0; y < y1; ++y) {
+                            for (unsigned int x = x0; x < x1; ++x) {
+                                const std::size_t i = std::size_t(y) * size + x;
+                                const glm::vec3 N(directions->getX(face)[i], directions->getY(face)[i], directions->getZ(face)[i]);
+                                float rgb[3];
+#ifdef GGXPREFILTER_AVX2
+                                if (avx2) {
+                                    prefilterTexelAvx2(cube, table, axes, N, rgb);
+                                }
+                                else {
+                                    prefilterTexelScalar(cube, table, N, rgb);
+                                }
+#else
+                                prefilterTexelScalar(cube, table, N, rgb);
+#endif
+                                for (unsigned int c = 0; c < 3; ++c) {
+                                    pixels.at(c, x, y) = rgb[c];
+                                }
+                            }
+                        }
+                        levelMicroseconds[mip] += (long long)(timer.elapsedMs() * 1000.0);
+                    };
+                    tasks.push_back(task);
+                }
+            }
+        }
+    }
+    const TaskScheduler::Stats stats = scheduler.run(tasks);
+
+    for (unsigned int mip = 0; mip < levels; ++mip) {
+        std::ostringstream stage;
+        stage << "prefilter level " << mip << " (" << target.getSize(mip) << "px, roughness " << (levels > 1 ? float(mip) / float(levels - 1) : 0.0f)
+            << (tables[mip].count == 0 ? ", copy" : ", " + std::to_string(tables[mip].count) + " samples") << ", thread time)";
+        report.addTiming(stage.str(), levelMicroseconds[mip] / 1000.0);
+    }
+    report.addTiming("prefilter wall time", stats.wallMs);
+    std::ostringstream throughput;
+    throughput.precision(1);
+    throughput << std::fixed << (stats.wallMs > 0.0 ? totalCost / (stats.wallMs * 1000.0) : 0.0) << " Msamples/s";
+    report.addValue("prefilter throughput", throughput.str());
+    stats.addTo(report, "prefilter scheduler");
+    return target;
+}
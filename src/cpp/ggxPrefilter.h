@@ -0,0 +1,42 @@
+#ifndef GGXPREFILTER_H
+#define GGXPREFILTER_H
+
+// Include standard libraries
+#include <vector>
+// Include own classes
+#include "./arena.h"
+#include "./cubeImage.h"
+#include "./report.h"
+#include "./taskScheduler.h"
+
+/**
+* \brief The specular GGX prefilter of prefilterEnvIBL.frag.glsl on the CPU.
+*
+* The shader assumes V = N, so every sample only depends on the roughness: the reflected direction in tangent space,
+* its NdotL weight and its LOD are computed once per level into a sample table and shared by all texels. A texel then
+* only rotates the table into its tangent frame and does the lookups. The source cube is copied to planar faces with a
+* one texel border from the neighbouring faces, so every bilinear tap is a plain array access like a seamless cube map
+* and one index addresses the texel in all three planes.
+*
+* With AVX2 available at runtime 8 samples are processed at once, otherwise a scalar loop is used. The samples of a
+* texel are scattered over the cube, so their texels are fetched with gathers. All levels are split into tiles of about the same estimated cost (texels x samples) and run on a
+* TaskScheduler. A level with roughness 0 and the size of the source is the source itself and only copied.
+**/
+namespace ggxPrefilter {
+    /**
+    * Prefilters a cube into a new one. Level i gets roughness i / (levels - 1).
+    *
+    * \param CubeImage& source The cube with its complete mip chain
+    * \param unsigned int levels The number of prefiltered levels
+    * \param const std::vector<unsigned int>& sampleCounts The samples per texel of every level, see sampleSchedule.
+    * Missing levels use sampleSchedule::fullSamples like the shader.
+    * \param bool releaseSource Frees the source as soon as its padded copy exists, before the result is allocated
+    * \param TaskScheduler& scheduler Runs the tiles
+    * \param Report& report Receives the time spent on every level, the sample throughput and the scheduler statistics
+    * \param Arena& arena Supplies the padded copy of the source, it is rewound when done
+    * \return The prefiltered cube, level 0 has the side width of the source
+    **/
+    CubeImage prefilter(CubeImage& source, unsigned int levels, const std::vector<unsigned int>& sampleCounts, bool releaseSource, TaskScheduler& scheduler, Report& report, Arena& arena);
+}
+
+#endif // GGXPREFILTER_H
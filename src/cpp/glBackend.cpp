@@ -0,0 +1,887 @@
+// Include own header
+#include "./glBackend.h"
+#include "./constants.h"
+#include "./sourcePyramid.h"
+#include "./cubeImage.h"
+#include "./cubeMipBuilder.h"
+#include "./programCache.h"
+#include "./sampleSchedule.h"
+#include "./shIrradiance.h"
+// Include algorithm for min and max
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+    const double PI = 3.14159265358979;
+    /// The uniform buffer binding point of the Capture block.
+    const GLuint captureBinding = 0;
+
+    /// GLFW is initialized once for all backends of the process and terminated with the last one.
+    std::mutex glfwMutex;
+    unsigned int glfwUsers = 0;
+
+    bool acquireGlfw() {
+        std::lock_guard<std::mutex> lock(glfwMutex);
+        if (glfwUsers == 0 && !glfwInit()) {
+            return false;
+        }
+        glfwUsers++;
+        return true;
+    }
+
+    void releaseGlfw() {
+        std::lock_guard<std::mutex> lock(glfwMutex);
+        if (glfwUsers > 0 && --glfwUsers == 0) {
+            glfwTerminate();
+        }
+    }
+}
+
+// Forward declaration... GLFW does not like the callback inside the class structure.
+void window_size_callback(GLFWwindow* window, int width, int height);
+
+GLBackend::GLBackend(Report& report, Arena& arena) : Backend(report, arena) {
+    Timer timer;
+    // glfw: initialize and configure
+    if (!acquireGlfw()) {
+        std::cout << "Failed to init GLFW" << std::endl;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // glfw window creation
+    this->window = glfwCreateWindow(1, 1, "EnvMapGen", NULL, NULL);
+    if (window == NULL)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+    }
+    glfwHideWindow(window);
+    glfwSetWindowSize(window, SRC_WIDTH, SRC_HEIGHT);
+    glfwMakeContextCurrent(window);
+    glfwSetFramebufferSizeCallback(window, window_size_callback);
+
+    // glad: load all OpenGL function pointers. They are shared by all contexts of the process, which all use the
+    // same driver, so loading them again while another backend renders writes the same values.
+    {
+        std::lock_guard<std::mutex> lock(glfwMutex);
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+        {
+            std::cout << "Failed to initialize GLAD" << std::endl;
+        }
+    }
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LEQUAL); // set depth function to less than AND equal for skybox depth trick.
+    glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS); // enable to avoid seams
+    glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
+
+    this->initShader();
+    this->report.addTiming("gl startup", timer.elapsedMs());
+}
+
+GLBackend::~GLBackend() {
+    // The objects have to be deleted while the context exists and is current
+    glfwMakeContextCurrent(this->window);
+    this->displayShader = ShaderProgram();
+    this->equirectangularToCubemapShader = ShaderProgram();
+    this->irradianceShader = ShaderProgram();
+    this->prefilterEnvironmentShader = ShaderProgram();
+    this->skyboxShader = ShaderProgram();
+    this->probeEquirectangularToCubemapShader = ShaderProgram();
+    this->probeIrradianceShader = ShaderProgram();
+    this->prefilterVariants.clear();
+    this->captureUBO.reset();
+    this->HDRsrcTexture.reset();
+    this->cubeVAO.reset();
+    this->cubeVBO.reset();
+    this->quadVAO.reset();
+    this->quadVBO.reset();
+    this->captureFBO.reset();
+    this->captureRBO.reset();
+    this->captureColorbuffer.reset();
+    this->irradianceColorbuffer.reset();
+    this->environmentColorbuffer.reset();
+    this->probeFBO.reset();
+    this->releaseProbeBatch();
+    this->pool.clear();
+    // Only this context goes, other backends keep theirs
+    glfwMakeContextCurrent(NULL);
+    if (this->window != NULL) {
+        glfwDestroyWindow(this->window);
+    }
+    releaseGlfw();
+}
+
+std::string GLBackend::getName() const {
+    return "gl";
+}
+
+GLFWwindow* GLBackend::getWindow() const {
+    return this->window;
+}
+
+void GLBackend::uploadSource(const float* rgb, unsigned int width, unsigned int height) {
+    // glGenerateMipmap would box filter without respecting the latitude, see SourcePyramid
+    Timer timer;
+    const ArenaScope scope(this->arena);
+    PlanarImage planes(width, height, &this->arena);
+    PlanarImage::deinterleave(rgb, planes.getView());
+    this->pendingSource.reset(new SourcePyramid(planes.getView(), this->arena));
+    this->report.addTiming("gl source pyramid", timer.elapsedMs());
+    this->srcHeight = height;
+    // A new job starts, sizes the previous one used and this one does not are given up
+    this->HDRsrcTexture.reset();
+    this->pool.trim();
+}
+
+void GLBackend::uploadSourceLevels(unsigned int faceSize) {
+    if (!this->pendingSource || faceSize == 0) {
+        std::cout << "ERROR: No source uploaded for the base cube" << std::endl;
+        throw(2);
+    }
+    const SourcePyramid& pyramid = *this->pendingSource;
+    // equiToCube.frag.glsl picks the highest LOD in the face centers, trilinear filtering needs the level above
+    const double maxLod = std::log2(2.0 * this->srcHeight / (PI * faceSize));
+    const unsigned int levels = std::min(maxLod > 0.0 ? (unsigned int)std::ceil(maxLod) + 1 : 1u, pyramid.getLevelCount());
+    this->report.addValue("source pyramid levels", std::to_string(levels) + " of " + std::to_string(pyramid.getLevelCount()) + " uploaded");
+
+    this->HDRsrcTexture = this->pool.acquire(GLResourceKey(GL_TEXTURE_2D, pyramid.getWidth(0), pyramid.getHeight(0), GL_RGB16F, levels));
+    // Level 0 is the biggest, so one buffer takes every level
+    const ArenaScope scope(this->arena);
+    float* pixels = (float*)this->arena.allocate(std::size_t(pyramid.getWidth(0)) * pyramid.getHeight(0) * 3 * sizeof(float));
+    for (unsigned int level = 0; level < levels; ++level) {
+        PlanarImage::interleave(pyramid.getLevel(level), pixels);
+        glTexSubImage2D(GL_TEXTURE_2D, // Type of texture
+            level,// Pyramid level (for mip-mapping) - 0 is the top level
+            0, 0,// Offset, the whole level is written
+            pyramid.getWidth(level),// Image width
+            pyramid.getHeight(level),// Image height
+            GL_RGB,// Format of image pixel data
+            GL_FLOAT,// Image data type
+            pixels);// The actual image data itself
+    }
+
+    // The longitude wraps around, the latitude does not
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // The texture is the only copy now, unless another base cube is rendered later
+    if (!this->keepSource) {
+        this->pendingSource.reset();
+    }
+}
+
+void GLBackend::initShader() {
+    // Compiling takes a noticeable part of a short job, later runs load the driver binaries
+    this->programs.reset(new ProgramCache("./shadercache"));
+    this->displayShader = this->loadProgram("texturedPlane.vert.glsl", "texturedPlane.frag.glsl");
+    this->equirectangularToCubemapShader = this->loadProgram("std.vert.glsl", "equiToCube.frag.glsl");
+    this->irradianceShader = this->loadProgram("std.vert.glsl", "diffuseIBL.frag.glsl");
+    this->prefilterEnvironmentShader = this->loadProgram("std.vert.glsl", "prefilterEnvIBL.frag.glsl");
+    this->skyboxShader = this->loadProgram("simpleSkybox.vert.glsl", "simpleSkybox.frag.glsl");
+    this->programs->addTo(this->report, "gl shader programs");
+
+    // The matrices never change, so they are uploaded once instead of set per draw
+    this->captureUBO = GLHandle(GLHandle::Kind::Buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, this->captureUBO.get());
+    glBufferData(GL_UNIFORM_BUFFER, 7 * sizeof(glm::mat4), NULL, GL_STATIC_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), &this->captureProjection[0][0]);
+    glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), 6 * sizeof(glm::mat4), &captureViews[0][0][0]);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, captureBinding, this->captureUBO.get());
+}
+
+ShaderProgram GLBackend::loadProgram(const std::string& vertexName, const std::string& fragmentName, const std::string& defines, const std::string& geometryName) {
+    ShaderProgram program = this->programs->load(vertexName, fragmentName, defines, geometryName);
+    program.bindUniformBlock("Capture", captureBinding);
+    return program;
+}
+
+const ShaderProgram& GLBackend::getPrefilterVariant(float roughness, unsigned int sampleCount, bool probeArray, std::string& name) {
+    std::ostringstream defines;
+    if (probeArray) {
+        defines << "#define PROBE_ARRAY\n";
+    }
+    if (roughness == 0.0f) {
+        name = "copy variant";
+        defines << "#define ROUGHNESS_ZERO\n";
+    }
+    else {
+        name = "constant roughness variant";
+        // Nine digits give back the same float as the uniform had
+        defines << std::setprecision(9) << std::showpoint << "#define ROUGHNESS " << roughness << "\n";
+        if (sampleCount != sampleSchedule::fullSamples) {
+            name += ", " + std::to_string(sampleCount) + " samples";
+            defines << "#define SAMPLE_COUNT " << sampleCount << "u\n";
+        }
+    }
+    auto found = this->prefilterVariants.find(defines.str());
+    if (found == this->prefilterVariants.end()) {
+        found = this->prefilterVariants.insert(std::make_pair(defines.str(), probeArray
+            ? this->loadProgram("probe.vert.glsl", "prefilterEnvIBL.frag.glsl", defines.str(), "probe.geom.glsl")
+            : this->loadProgram("std.vert.glsl", "prefilterEnvIBL.frag.glsl", defines.str()))).first;
+    }
+    return found->second;
+}
+
+void GLBackend::renderPrefilteredLevel(const ShaderProgram& shader, unsigned int mip, float roughness, const GLHandle& query) {
+    // reisze framebuffer according to mip-level size.
+    const unsigned int mipWidth = this->faceSize >> mip;
+    this->bindCaptureFramebuffer(mipWidth);
+    glViewport(0, 0, mipWidth, mipWidth);
+
+    shader.use();
+    shader.setInt("environmentMap", 0);
+    shader.setFloat("roughness", roughness);
+    shader.setFloat("resolution", float(this->faceSize));
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, this->captureColorbuffer.get());
+
+    glBeginQuery(GL_TIME_ELAPSED, query.get());
+    Timer timer;
+    const GLint face = shader.getLocation("face");
+    for (unsigned int i = 0; i < 6; ++i)
+    {
+        shader.setInt(face, i);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+            GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, this->environmentColorbuffer.get(), mip);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        renderCube();
+    }
+    this->drawSubmitMs += timer.elapsedMs();
+    this->drawCount += 6;
+    glEndQuery(GL_TIME_ELAPSED);
+}
+
+void GLBackend::bindCaptureFramebuffer(int sideWidth) {
+    if (this->captureFBO.get() == 0) {
+        this->captureFBO = GLHandle(GLHandle::Kind::Framebuffer);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, this->captureFBO.get());
+    // create a renderbuffer object (we won't be sampling these). The previous one goes back first, so a capture
+    // of the same size gets it again.
+    this->captureRBO.reset();
+    this->captureRBO = this->pool.acquire(GLResourceKey(GL_RENDERBUFFER, sideWidth, sideWidth, GL_RGB, 1));
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_RENDERBUFFER, this->captureRBO.get());
+    // now that we actually created the framebuffer and added all attachments we want to check if it is actually complete now
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
+}
+
+GLHandle GLBackend::createCube(const int sideWidth, unsigned int levels) {
+    if (levels == 0) {
+        levels = CubeImage::fullLevelCount(sideWidth);
+    }
+    GLHandle cubeTexture = this->pool.acquire(GLResourceKey(GL_TEXTURE_CUBE_MAP, sideWidth, sideWidth, GL_RGB16F, levels));
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return cubeTexture;
+}
+
+void GLBackend::renderDisplay() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    this->displayShader.use();
+    glViewport(0, 0, SRC_WIDTH, SRC_HEIGHT);
+    glBindTexture(GL_TEXTURE_2D, this->HDRsrcTexture.get());
+    renderQuad();
+    glfwSwapBuffers(this->window);
+}
+
+void GLBackend::renderSkybox() {
+
+    this->skyboxShader.use();
+    skyboxShader.setInt("environmentMap", 0);
+    skyboxShader.setMat4("projection", captureProjection);
+    skyboxShader.setMat4("view", captureViews[5]);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, this->captureColorbuffer.get());
+
+    renderCube();
+    glfwSwapBuffers(this->window);
+}
+
+void GLBackend::makeBaseCube(unsigned int faceSize) {
+    // Low memory mode deletes every released texture instead of keeping it for the next stage or job
+    this->pool.setKeepReleased(!this->lowMemory);
+    this->uploadSourceLevels(faceSize);
+    this->equirectangularToCubemapShader.use();
+    this->equirectangularToCubemapShader.setInt("equirectangularMap", 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, this->HDRsrcTexture.get());
+
+    this->faceSize = faceSize;
+    // The mip chain is filled by generateCubeMipmaps
+    this->captureColorbuffer = this->createCube(faceSize, 0);
+    // Needed to pick the source pyramid level per texel
+    this->equirectangularToCubemapShader.setFloat("faceSize", float(faceSize));
+    this->equirectangularToCubemapShader.setFloat("srcHeight", float(this->srcHeight));
+
+    captureCubeFaces(faceSize, this->captureColorbuffer.get(), this->equirectangularToCubemapShader);
+    // Nothing samples the source after the base cube
+    this->HDRsrcTexture.reset();
+    // then generate mipmaps
+    this->generateCubeMipmaps(this->captureColorbuffer.get(), faceSize);
+}
+
+void GLBackend::generateCubeMipmaps(const unsigned int cubeTexture, const int sideWidth) {
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cubeTexture);
+    // The prefilter shader picks its mip level per sample, so the chain has to be sampled
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    if (!this->cpuMipmaps) {
+        glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+        return;
+    }
+    // Read back level 0, filter seam aware on the CPU and upload the chain
+    const ArenaScope scope(this->arena);
+    CubeImage cube(sideWidth, 0, &this->arena);
+    float* pixels = (float*)this->arena.allocate(std::size_t(sideWidth) * sideWidth * 3 * sizeof(float));
+    for (unsigned int i = 0; i < 6; ++i) {
+        glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, GL_FLOAT, pixels);
+        PlanarImage::deinterleave(pixels, cube.getFace(0, i));
+    }
+    cubeMipBuilder::build(cube, this->report, this->arena);
+    for (unsigned int level = 1; level < cube.getLevelCount(); ++level) {
+        for (unsigned int i = 0; i < 6; ++i) {
+            PlanarImage::interleave(cube.getFace(level, i), pixels);
+            glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, level, 0, 0, cube.getSize(level), cube.getSize(level), GL_RGB, GL_FLOAT, pixels);
+        }
+    }
+}
+
+void GLBackend::makePrefilteredChain(unsigned int levels, bool releaseBackground) {
+    const int sideWidth = this->faceSize;
+
+    // Only the rendered levels, nothing samples below them
+    this->prefilteredLevels = std::min(levels, CubeImage::fullLevelCount(sideWidth));
+    this->environmentColorbuffer = this->createCube(sideWidth, this->prefilteredLevels);
+
+    // Every level gets the program specialized for its roughness and sample count, built or loaded before the
+    // first draw. A level with roughness 0 and the size of the background is the background itself, it is copied.
+    Timer timer;
+    std::vector<const ShaderProgram*> variants;
+    std::vector<std::string> variantNames(this->prefilteredLevels);
+    for (unsigned int mip = 0; mip < this->prefilteredLevels; ++mip) {
+        const float roughness = levels > 1 ? (float)mip / (float)(levels - 1) : 0.0f;
+        if (roughness == 0.0f && mip == 0) {
+            variantNames[mip] = "copy";
+            variants.push_back(nullptr);
+            continue;
+        }
+        const unsigned int sampleCount = mip < this->sampleCounts.size() ? this->sampleCounts[mip] : sampleSchedule::fullSamples;
+        variants.push_back(&this->getPrefilterVariant(roughness, sampleCount, false, variantNames[mip]));
+    }
+    this->report.addTiming("gl prefilter variants", timer.elapsedMs());
+
+    // Optionally the generic program is timed first on the same level
+    std::vector<GLHandle> variantQueries;
+    std::vector<GLHandle> genericQueries;
+    for (unsigned int mip = 0; mip < this->prefilteredLevels; ++mip)
+    {
+        const float roughness = levels > 1 ? (float)mip / (float)(levels - 1) : 0.0f;
+        if (this->compareShaderVariants) {
+            genericQueries.push_back(GLHandle(GLHandle::Kind::Query));
+            this->renderPrefilteredLevel(this->prefilterEnvironmentShader, mip, roughness, genericQueries.back());
+        }
+        variantQueries.push_back(GLHandle(GLHandle::Kind::Query));
+        if (variants[mip] == nullptr) {
+            glBeginQuery(GL_TIME_ELAPSED, variantQueries.back().get());
+            glCopyImageSubData(this->captureColorbuffer.get(), GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+                this->environmentColorbuffer.get(), GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0, sideWidth, sideWidth, 6);
+            glEndQuery(GL_TIME_ELAPSED);
+        }
+        else {
+            this->renderPrefilteredLevel(*variants[mip], mip, roughness, variantQueries.back());
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // Reading the results waits for the GPU
+    for (unsigned int mip = 0; mip < this->prefilteredLevels; ++mip) {
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(variantQueries[mip].get(), GL_QUERY_RESULT, &nanoseconds);
+        const double ms = nanoseconds / 1.0e6;
+        std::ostringstream stage;
+        stage << "gl prefilter level " << mip << " (" << (sideWidth >> mip) << "px, roughness " << (levels > 1 ? float(mip) / float(levels - 1) : 0.0f) << ", " << variantNames[mip] << ", gpu time)";
+        this->report.addTiming(stage.str(), ms);
+        if (this->compareShaderVariants) {
+            glGetQueryObjectui64v(genericQueries[mip].get(), GL_QUERY_RESULT, &nanoseconds);
+            const double genericMs = nanoseconds / 1.0e6;
+            std::ostringstream gain;
+            gain << std::fixed << std::setprecision(2) << "generic " << genericMs << " ms, variant " << ms << " ms, " << (ms > 0.0 ? genericMs / ms : 0.0) << "x";
+            this->report.addValue("gl prefilter level " + std::to_string(mip) + " gain", gain.str());
+        }
+    }
+    if (releaseBackground) {
+        // The draws above are queued with the texture, the driver frees it when they are done
+        this->captureColorbuffer.reset();
+    }
+}
+
+GLHandle GLBackend::blitCube(const GLHandle& cube, int srcWidth, int sideWidth, unsigned int levels, unsigned int allocatedLevels) {
+    GLHandle target = this->createCube(sideWidth, allocatedLevels);
+    const GLHandle readFBO(GLHandle::Kind::Framebuffer);
+    const GLHandle drawFBO(GLHandle::Kind::Framebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFBO.get());
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFBO.get());
+    for (unsigned int i = 0; i < 6; ++i) {
+        // A linear blit to exactly half the size averages 2x2 texels
+        for (unsigned int mip = 0; mip < levels; ++mip) {
+            const int srcMipWidth = std::max(srcWidth >> mip, 1);
+            const int mipWidth = std::max(sideWidth >> mip, 1);
+            glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, cube.get(), mip);
+            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, target.get(), mip);
+            glBlitFramebuffer(0, 0, srcMipWidth, srcMipWidth, 0, 0, mipWidth, mipWidth, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return target;
+}
+
+void GLBackend::downsampleProducts(unsigned int faceSize) {
+    const int srcWidth = this->faceSize;
+    const int sideWidth = faceSize;
+    // One product after the other, each previous cube goes back to the pool before the next one is created
+    if (this->captureColorbuffer.get() != 0) {
+        GLHandle background = this->blitCube(this->captureColorbuffer, srcWidth, sideWidth, 1, 0);
+        this->captureColorbuffer.reset();
+        // The background cube is sampled with mipmaps like the one from makeBaseCube
+        this->generateCubeMipmaps(background.get(), sideWidth);
+        this->captureColorbuffer = std::move(background);
+    }
+    if (this->environmentColorbuffer.get() != 0) {
+        // Every prefiltered level keeps its roughness, only its resolution shrinks
+        const unsigned int levels = std::min(this->prefilteredLevels, CubeImage::fullLevelCount(sideWidth));
+        this->environmentColorbuffer = this->blitCube(this->environmentColorbuffer, srcWidth, sideWidth, levels, levels);
+    }
+    this->faceSize = sideWidth;
+}
+
+void GLBackend::releaseProduct(Product product) {
+    this->getHandle(product).reset();
+}
+
+void GLBackend::makeIrradiance(unsigned int faceSize) {
+    this->irradianceColorbuffer = this->createCube(faceSize, 1);
+    if (this->irradianceMethod == IrradianceMethod::SphericalHarmonics) {
+        // Read back a small level of the background, project and evaluate on the CPU and upload the result
+        const ArenaScope scope(this->arena);
+        const unsigned int level = shIrradiance::projectionLevel(this->faceSize);
+        const unsigned int size = std::max(this->faceSize >> level, 1u);
+        CubeImage radiance(size, 1, &this->arena);
+        CubeImage irradiance(faceSize, 1, &this->arena);
+        float* pixels = (float*)this->arena.allocate(std::size_t(std::max(size, faceSize)) * std::max(size, faceSize) * 3 * sizeof(float));
+        glBindTexture(GL_TEXTURE_CUBE_MAP, this->captureColorbuffer.get());
+        for (unsigned int i = 0; i < 6; ++i) {
+            glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, level, GL_RGB, GL_FLOAT, pixels);
+            PlanarImage::deinterleave(pixels, radiance.getFace(0, i));
+        }
+        shIrradiance::evaluate(shIrradiance::project(radiance, 0, this->report), irradiance, this->report);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, this->irradianceColorbuffer.get());
+        for (unsigned int i = 0; i < 6; ++i) {
+            PlanarImage::interleave(irradiance.getFace(0, i), pixels);
+            glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, 0, 0, faceSize, faceSize, GL_RGB, GL_FLOAT, pixels);
+        }
+        return;
+    }
+
+    this->irradianceShader.use();
+    this->irradianceShader.setInt("environmentMap", 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, this->captureColorbuffer.get());
+
+    captureCubeFaces(faceSize, this->irradianceColorbuffer.get(), this->irradianceShader);
+}
+
+void GLBackend::finish() {
+    glFinish();
+}
+
+void GLBackend::attachThread() {
+    glfwMakeContextCurrent(this->window);
+}
+
+void GLBackend::detachThread() {
+    // Issued work has to be submitted before another thread takes the context
+    glFlush();
+    glfwMakeContextCurrent(NULL);
+}
+
+unsigned int GLBackend::getMaxProbeBatch() const {
+    GLint layers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &layers);
+    return (unsigned int)std::max(layers, 0) / 6;
+}
+
+void GLBackend::makeProbeBatch(const std::vector<const float*>& sources, unsigned int width, unsigned int height,
+    unsigned int faceSize, unsigned int irradianceSize, unsigned int levels) {
+    this->pool.setKeepReleased(!this->lowMemory);
+    // The arrays of the previous batch go back first, so a batch of the same size gets them again
+    this->releaseProbeBatch();
+    const unsigned int probes = (unsigned int)sources.size();
+    if (probes == 0) {
+        return;
+    }
+    if (this->probeEquirectangularToCubemapShader.get() == 0) {
+        Timer timer;
+        this->probeEquirectangularToCubemapShader = this->loadProgram("probe.vert.glsl", "equiToCube.frag.glsl", "#define PROBE_ARRAY\n", "probe.geom.glsl");
+        this->probeIrradianceShader = this->loadProgram("probe.vert.glsl", "diffuseIBL.frag.glsl", "#define PROBE_ARRAY\n", "probe.geom.glsl");
+        this->report.addTiming("gl probe programs", timer.elapsedMs());
+    }
+    if (this->probeFBO.get() == 0) {
+        this->probeFBO = GLHandle(GLHandle::Kind::Framebuffer);
+    }
+    this->probeCount = probes;
+
+    // One layer per source with the pyramid levels the face size samples, see uploadSourceLevels
+    Timer timer;
+    GLHandle sourceArray;
+    {
+        const ArenaScope scope(this->arena);
+        float* pixels = (float*)this->arena.allocate(std::size_t(width) * height * 3 * sizeof(float));
+        const double maxLod = std::log2(2.0 * height / (PI * faceSize));
+        unsigned int sourceLevels = 0;
+        for (unsigned int probe = 0; probe < probes; ++probe) {
+            const ArenaScope probeScope(this->arena);
+            PlanarImage planes(width, height, &this->arena);
+            PlanarImage::deinterleave(sources[probe], planes.getView());
+            const SourcePyramid pyramid(planes.getView(), this->arena);
+            if (probe == 0) {
+                sourceLevels = std::min(maxLod > 0.0 ? (unsigned int)std::ceil(maxLod) + 1 : 1u, pyramid.getLevelCount());
+                sourceArray = this->pool.acquire(GLResourceKey(GL_TEXTURE_2D_ARRAY, width, height, GL_RGB16F, sourceLevels, probes));
+                glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+                glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            }
+            for (unsigned int level = 0; level < sourceLevels; ++level) {
+                PlanarImage::interleave(pyramid.getLevel(level), pixels);
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, probe, pyramid.getWidth(level), pyramid.getHeight(level), 1, GL_RGB, GL_FLOAT, pixels);
+            }
+        }
+    }
+    this->probeStageMs[0] += timer.elapsedMs();
+
+    // Every stage is one instanced draw for all faces of all probes
+    timer.restart();
+    this->probeBackgrounds = this->createCubeArray(faceSize, 0, probes);
+    this->bindProbeFramebuffer(this->probeBackgrounds, 0, faceSize);
+    this->probeEquirectangularToCubemapShader.use();
+    this->probeEquirectangularToCubemapShader.setInt("equirectangularMap", 0);
+    this->probeEquirectangularToCubemapShader.setFloat("faceSize", float(faceSize));
+    this->probeEquirectangularToCubemapShader.setFloat("srcHeight", float(height));
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, sourceArray.get());
+    this->renderProbeCubes(probes);
+    sourceArray.reset();
+    glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, this->probeBackgrounds.get());
+    glGenerateMipmap(GL_TEXTURE_CUBE_MAP_ARRAY);
+    glFinish();
+    this->probeStageMs[1] += timer.elapsedMs();
+
+    timer.restart();
+    this->probeIrradiance = this->createCubeArray(irradianceSize, 1, probes);
+    if (this->irradianceMethod == IrradianceMethod::SphericalHarmonics) {
+        // A small level of all backgrounds is read back at once, every probe is projected and evaluated on the CPU
+        const ArenaScope scope(this->arena);
+        const unsigned int level = shIrradiance::projectionLevel(faceSize);
+        const unsigned int size = std::max(faceSize >> level, 1u);
+        const std::size_t faceFloats = std::size_t(size) * size * 3;
+        const std::size_t irradianceFloats = std::size_t(irradianceSize) * irradianceSize * 3;
+        float* radianceLayers = (float*)this->arena.allocate(faceFloats * 6 * probes * sizeof(float));
+        float* pixels = (float*)this->arena.allocate(irradianceFloats * 6 * sizeof(float));
+        glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, this->probeBackgrounds.get());
+        glGetTexImage(GL_TEXTURE_CUBE_MAP_ARRAY, level, GL_RGB, GL_FLOAT, radianceLayers);
+        CubeImage radiance(size, 1, &this->arena);
+        CubeImage irradiance(irradianceSize, 1, &this->arena);
+        // The stages of shIrradiance would add a line per probe
+        Report probeReport;
+        glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, this->probeIrradiance.get());
+        for (unsigned int probe = 0; probe < probes; ++probe) {
+            for (unsigned int i = 0; i < 6; ++i) {
+                PlanarImage::deinterleave(radianceLayers + (std::size_t(probe) * 6 + i) * faceFloats, radiance.getFace(0, i));
+            }
+            shIrradiance::evaluate(shIrradiance::project(radiance, 0, probeReport), irradiance, probeReport);
+            for (unsigned int i = 0; i < 6; ++i) {
+                PlanarImage::interleave(irradiance.getFace(0, i), pixels + i * irradianceFloats);
+            }
+            glTexSubImage3D(GL_TEXTURE_CUBE_MAP_ARRAY, 0, 0, 0, probe * 6, irradianceSize, irradianceSize, 6, GL_RGB, GL_FLOAT, pixels);
+        }
+    }
+    else {
+        this->bindProbeFramebuffer(this->probeIrradiance, 0, irradianceSize);
+        this->probeIrradianceShader.use();
+        this->probeIrradianceShader.setInt("environmentMap", 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, this->probeBackgrounds.get());
+        this->renderProbeCubes(probes);
+    }
+    glFinish();
+    this->probeStageMs[2] += timer.elapsedMs();
+
+    // Like makePrefilteredChain, level 0 with roughness 0 is a copy of the backgrounds
+    timer.restart();
+    const unsigned int prefiltered = std::min(levels, CubeImage::fullLevelCount(faceSize));
+    this->probePrefiltered = this->createCubeArray(faceSize, prefiltered, probes);
+    std::vector<GLHandle> queries;
+    for (unsigned int mip = 0; mip < prefiltered; ++mip) {
+        const float roughness = levels > 1 ? (float)mip / (float)(levels - 1) : 0.0f;
+        const int mipWidth = std::max(int(faceSize >> mip), 1);
+        queries.push_back(GLHandle(GLHandle::Kind::Query));
+        glBeginQuery(GL_TIME_ELAPSED, queries.back().get());
+        if (roughness == 0.0f && mip == 0) {
+            glCopyImageSubData(this->probeBackgrounds.get(), GL_TEXTURE_CUBE_MAP_ARRAY, 0, 0, 0, 0,
+                this->probePrefiltered.get(), GL_TEXTURE_CUBE_MAP_ARRAY, 0, 0, 0, 0, faceSize, faceSize, 6 * probes);
+        }
+        else {
+            std::string name;
+            const unsigned int sampleCount = mip < this->sampleCounts.size() ? this->sampleCounts[mip] : sampleSchedule::fullSamples;
+            const ShaderProgram& shader = this->getPrefilterVariant(roughness, sampleCount, true, name);
+            this->bindProbeFramebuffer(this->probePrefiltered, mip, mipWidth);
+            shader.use();
+            shader.setInt("environmentMap", 0);
+            shader.setFloat("roughness", roughness);
+            shader.setFloat("resolution", float(faceSize));
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, this->probeBackgrounds.get());
+            this->renderProbeCubes(probes);
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    this->probeLevelGpuMs.resize(std::max(this->probeLevelGpuMs.size(), std::size_t(prefiltered)), 0.0);
+    for (unsigned int mip = 0; mip < prefiltered; ++mip) {
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries[mip].get(), GL_QUERY_RESULT, &nanoseconds);
+        this->probeLevelGpuMs[mip] += nanoseconds / 1.0e6;
+    }
+    this->probeStageMs[3] += timer.elapsedMs();
+    this->probeBatches++;
+    this->probesRendered += probes;
+}
+
+bool GLBackend::readBackProbeLevel(Product product, unsigned int level, float* rgb) {
+    const GLHandle& texture = product == Product::Background ? this->probeBackgrounds
+        : product == Product::Irradiance ? this->probeIrradiance : this->probePrefiltered;
+    if (texture.get() == 0) {
+        return false;
+    }
+    // All layers in one transfer, the faces of a probe are consecutive layers
+    glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, texture.get());
+    glGetTexImage(GL_TEXTURE_CUBE_MAP_ARRAY, level, GL_RGB, GL_FLOAT, rgb);
+    return true;
+}
+
+void GLBackend::releaseProbeBatch() {
+    this->probeBackgrounds.reset();
+    this->probeIrradiance.reset();
+    this->probePrefiltered.reset();
+    this->probeCount = 0;
+}
+
+GLHandle GLBackend::createCubeArray(const int sideWidth, unsigned int levels, unsigned int probes) {
+    if (levels == 0) {
+        levels = CubeImage::fullLevelCount(sideWidth);
+    }
+    GLHandle cubeArray = this->pool.acquire(GLResourceKey(GL_TEXTURE_CUBE_MAP_ARRAY, sideWidth, sideWidth, GL_RGB16F, levels, 6 * probes));
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return cubeArray;
+}
+
+void GLBackend::bindProbeFramebuffer(const GLHandle& cubeArray, unsigned int level, int sideWidth) {
+    // Layered rendering needs every attachment layered, so there is no renderbuffer like in captureFBO
+    glBindFramebuffer(GL_FRAMEBUFFER, this->probeFBO.get());
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, cubeArray.get(), level);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::FRAMEBUFFER:: Probe framebuffer is not complete!" << std::endl;
+    glViewport(0, 0, sideWidth, sideWidth);
+}
+
+void GLBackend::renderProbeCubes(unsigned int probes) {
+    this->initCubeVertices();
+    Timer timer;
+    glClear(GL_COLOR_BUFFER_BIT);
+    glBindVertexArray(this->cubeVAO.get());
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, probes);
+    glBindVertexArray(0);
+    this->drawSubmitMs += timer.elapsedMs();
+    this->drawCount++;
+}
+
+void GLBackend::reportResources() {
+    if (this->probeBatches > 0) {
+        std::ostringstream batches;
+        batches << std::fixed << std::setprecision(1) << this->probesRendered << " probes in " << this->probeBatches << " batches, sources "
+            << this->probeStageMs[0] << " ms, base cubes " << this->probeStageMs[1] << " ms, irradiance " << this->probeStageMs[2]
+            << " ms, prefiltered " << this->probeStageMs[3] << " ms";
+        this->report.addValue("gl probe batches", batches.str());
+        std::ostringstream levels;
+        levels << std::fixed << std::setprecision(1);
+        for (std::size_t mip = 0; mip < this->probeLevelGpuMs.size(); ++mip) {
+            levels << (mip > 0 ? ", " : "") << this->probeLevelGpuMs[mip];
+        }
+        this->report.addValue("gl probe prefilter gpu time per level", levels.str() + " ms");
+    }
+    if (this->drawCount > 0) {
+        std::ostringstream overhead;
+        overhead << std::fixed << std::setprecision(1) << this->drawSubmitMs * 1000.0 / this->drawCount << " us over " << this->drawCount << " draws";
+        this->report.addValue("gl cpu time per draw", overhead.str());
+    }
+    this->report.addValue("gl textures and renderbuffers", this->pool.describe());
+    this->report.addValue("gpu peak", Report::formatBytes(this->pool.getPeakBytes()) + " in textures and renderbuffers (estimated)");
+    const std::size_t products = this->captureColorbuffer.getBytes() + this->irradianceColorbuffer.getBytes() + this->environmentColorbuffer.getBytes();
+    this->report.addValue("gl video memory", "source " + Report::formatBytes(this->HDRsrcTexture.getBytes())
+        + ", background " + Report::formatBytes(this->captureColorbuffer.getBytes())
+        + ", irradiance " + Report::formatBytes(this->irradianceColorbuffer.getBytes())
+        + ", prefiltered " + Report::formatBytes(this->environmentColorbuffer.getBytes())
+        + ", total " + Report::formatBytes(this->HDRsrcTexture.getBytes() + products) + " (estimated)");
+}
+
+GLHandle& GLBackend::getHandle(Product product) {
+    switch (product) {
+    case Product::Background:
+        return this->captureColorbuffer;
+    case Product::Irradiance:
+        return this->irradianceColorbuffer;
+    default:
+        return this->environmentColorbuffer;
+    }
+}
+
+unsigned int GLBackend::getTexture(Product product) const {
+    switch (product) {
+    case Product::Background:
+        return this->captureColorbuffer.get();
+    case Product::Irradiance:
+        return this->irradianceColorbuffer.get();
+    default:
+        return this->environmentColorbuffer.get();
+    }
+}
+
+unsigned int GLBackend::getSize(Product product, unsigned int level) const {
+    const unsigned int texture = this->getTexture(product);
+    if (texture == 0 || (product == Product::Irradiance && level > 0) || (product == Product::Prefiltered && level >= this->prefilteredLevels)) {
+        return 0;
+    }
+    GLint width = 0;
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+    glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X, level, GL_TEXTURE_WIDTH, &width); // get width of GL texture
+    return width;
+}
+
+bool GLBackend::readBackLevel(Product product, unsigned int face, unsigned int level, float* rgb) {
+    const unsigned int texture = this->getTexture(product);
+    if (texture == 0) {
+        return false;
+    }
+    GLint internalFormat;
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+    glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, level, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat); // get internal format type of GL texture
+    if (internalFormat != GL_RGB16F) {
+        std::cout << "ERROR: No HDR Image. Format: " << std::to_string(internalFormat) << std::endl;
+        return false;
+    }
+    glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, level, GL_RGB, GL_FLOAT, rgb);
+    return true;
+}
+
+void GLBackend::captureCubeFaces(const int sideWidth, const unsigned int cubeTexture, const ShaderProgram& shader) {
+    //Before drawing
+    glViewport(0, 0, sideWidth, sideWidth);
+    this->bindCaptureFramebuffer(sideWidth);
+    // render
+    Timer timer;
+    const GLint face = shader.getLocation("face");
+    for (int i = 0; i < 6; ++i)
+    {
+        shader.setInt(face, i);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, cubeTexture, 0);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        renderCube();
+    }
+    this->drawSubmitMs += timer.elapsedMs();
+    this->drawCount += 6;
+}
+
+// renderCube() renders a 1x1 3D cube in NDC.
+void GLBackend::renderCube() {
+    this->initCubeVertices();
+    // render Cube
+    glBindVertexArray(this->cubeVAO.get());
+    glDrawArrays(GL_TRIANGLES, 0, 36);
+    glBindVertexArray(0);
+}
+
+void GLBackend::initCubeVertices() {
+    // initialize (if necessary)
+    if (this->cubeVAO.get() == 0)
+    {
+        this->cubeVAO = GLHandle(GLHandle::Kind::VertexArray);
+        this->cubeVBO = GLHandle(GLHandle::Kind::Buffer);
+        // fill buffer
+        glBindBuffer(GL_ARRAY_BUFFER, this->cubeVBO.get());
+        glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
+        // link vertex attributes
+        glBindVertexArray(this->cubeVAO.get());
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+}
+
+// renderQuad() renders a 1x1 XY quad in NDC
+void GLBackend::renderQuad() {
+    if (this->quadVAO.get() == 0)
+    {
+        // setup plane VAO
+        this->quadVAO = GLHandle(GLHandle::Kind::VertexArray);
+        this->quadVBO = GLHandle(GLHandle::Kind::Buffer);
+        glBindVertexArray(this->quadVAO.get());
+        glBindBuffer(GL_ARRAY_BUFFER, this->quadVBO.get());
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
+        // Define positions location
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+        // Define uv location
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    }
+    glBindVertexArray(this->quadVAO.get());
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+void GLBackend::processWindowInput() const {
+    if (glfwGetKey(this->window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(this->window, true);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+void window_size_callback(GLFWwindow* window, int width, int height)
+{
+    // make sure the viewport matches the new window dimensions; note that width and
+    // height will be significantly larger than specified on retina displays.
+    glViewport(0, 0, width, height);
+}
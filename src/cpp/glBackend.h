@@ -0,0 +1,245 @@
+#ifndef GLBACKEND_H
+#define GLBACKEND_H
+
+// Include glad for OpenGL function pointers
+#include "glad/glad.h"
+// Include GLFW for window context. OpenGL does not work without...
+#include "GLFW/glfw3.h"
+// Include glm for vector and matrix operations
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+// Include standard libraries
+#include <map>
+#include <memory>
+#include <string>
+// Include own classes
+#include "./backend.h"
+#include "./glResources.h"
+#include "./programCache.h"
+#include "./shaderProgram.h"
+#include "./sourcePyramid.h"
+
+/**
+* \class GLBackend
+*
+* \brief Renders all products with OpenGL shaders.
+*
+* The cube faces are rendered into textures through a framebuffer with the captureViews matrices. All OpenGL
+* objects are owned by GLHandles, textures and renderbuffers come from a GLResourcePool, so nothing leaks and
+* released products are reused by the next stage or job that needs the same size.
+* Since OpenGL does not work without any window context and for debuging purposes the GLFW library is used.
+* Every backend has a context of its own, so several of them can render on different threads, see attachThread.
+* GLFW requires that backends are created and destroyed on the main thread.
+* While programming I used a lot of code originally from https://learnopengl.com. Thanks to the author :-)
+**/
+class GLBackend : public Backend {
+public:
+    /**
+    * \brief Creates the hidden window, the OpenGL context and all shaders.
+    *
+    * \param Report& report Receives the measurements of the backend
+    * \param Arena& arena Supplies the transient buffers of the jobs
+    **/
+    GLBackend(Report& report, Arena& arena);
+    /// Frees all ressources
+    ~GLBackend();
+
+    std::string getName() const override;
+    void uploadSource(const float* rgb, unsigned int width, unsigned int height) override;
+    void makeBaseCube(unsigned int faceSize) override;
+    void makeIrradiance(unsigned int faceSize) override;
+    void makePrefilteredChain(unsigned int levels, bool releaseBackground) override;
+    void downsampleProducts(unsigned int faceSize) override;
+    void releaseProduct(Product product) override;
+    void finish() override;
+    void attachThread() override;
+    void detachThread() override;
+    unsigned int getMaxProbeBatch() const override;
+    void makeProbeBatch(const std::vector<const float*>& sources, unsigned int width, unsigned int height,
+        unsigned int faceSize, unsigned int irradianceSize, unsigned int levels) override;
+    bool readBackProbeLevel(Product product, unsigned int level, float* rgb) override;
+    void releaseProbeBatch() override;
+    void reportResources() override;
+    unsigned int getSize(Product product, unsigned int level) const override;
+    bool readBackLevel(Product product, unsigned int face, unsigned int level, float* rgb) override;
+
+    /// Debug function
+    GLFWwindow* getWindow() const;
+    /// Debug function
+    void renderDisplay();
+    /// Debug function
+    void renderSkybox();
+
+    /// Glfw callback function
+    void processWindowInput() const;
+
+private:
+    /// Windows width
+    const unsigned int SRC_WIDTH = 800;
+    /// Windows height
+    const unsigned int SRC_HEIGHT = 600;
+    /// For the window context.
+    GLFWwindow* window;
+    /// Loads the programs, from driver binaries if possible.
+    std::unique_ptr<ProgramCache> programs;
+    /// The different shader objects.
+    ShaderProgram displayShader, equirectangularToCubemapShader, irradianceShader, prefilterEnvironmentShader, skyboxShader;
+    /// The variants of prefilterEnvironmentShader specialized for a roughness by their defines.
+    std::map<std::string, ShaderProgram> prefilterVariants;
+    /// The Capture uniform block of std.vert.glsl: captureProjection and the six captureViews.
+    GLHandle captureUBO;
+    /// The draws issued to render cube faces.
+    unsigned long long drawCount = 0;
+    /// The CPU time spent issuing them, including the uniform updates.
+    double drawSubmitMs = 0.0;
+    /// The projection matrix used to render the cube faces, when rendering the cube textures.
+    const glm::mat4 captureProjection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 10.0f);
+
+    /// The height of the equirectangular source.
+    unsigned int srcHeight = 0;
+    /// The source between uploadSource and makeBaseCube, which uploads the levels the face size needs.
+    std::unique_ptr<SourcePyramid> pendingSource;
+    /// The side width of the background and prefiltered cubes.
+    unsigned int faceSize = 0;
+    /// The number of prefiltered levels.
+    unsigned int prefilteredLevels = 0;
+    /// Hands out the textures and renderbuffers. Declared before all handles, so it is destroyed after them.
+    GLResourcePool pool;
+    /// The eqirectangular texture object created from the src image.
+    GLHandle HDRsrcTexture;
+    /// The cubes vertex array object.
+    GLHandle cubeVAO;
+    /// The cubes vertex buffer object bound to cubeVAO.
+    GLHandle cubeVBO;
+    /// The planes vertex array object. This was used to render a simple plane to the screen for debugging.
+    GLHandle quadVAO;
+    /// The quads vertex buffer object bound to quadVAO.
+    GLHandle quadVBO;
+    /// The framebuffer all cube faces are rendered through.
+    GLHandle captureFBO;
+    /// The render buffer object bound to captureFBO, it has the size of the current capture.
+    GLHandle captureRBO;
+    /// The textures ID where the unchanged cube faces are saved in.
+    GLHandle captureColorbuffer;
+    /// The textures ID where the irradiance map is writen to.
+    GLHandle irradianceColorbuffer;
+    /// That is the textures ID for the prefiltered environment maps.
+    GLHandle environmentColorbuffer;
+    /// The programs rendering probe batches, loaded with the first batch.
+    ShaderProgram probeEquirectangularToCubemapShader, probeIrradianceShader;
+    /// The layered framebuffer probe batches are rendered through.
+    GLHandle probeFBO;
+    /// The products of the last probe batch, cube map arrays with six layers per probe.
+    GLHandle probeBackgrounds, probeIrradiance, probePrefiltered;
+    /// The number of probes of the last batch.
+    unsigned int probeCount = 0;
+    /// The batches and probes rendered so far.
+    unsigned long long probeBatches = 0, probesRendered = 0;
+    /// The time of the batch stages summed over all batches: sources, base cubes, irradiance and prefiltered chain.
+    double probeStageMs[4] = {};
+    /// The GPU time of every prefiltered level summed over all batches.
+    std::vector<double> probeLevelGpuMs;
+
+    /// Initializes all Shader objects and uploads the Capture uniform block.
+    void initShader();
+    /// Loads a program and connects its Capture uniform block, see ProgramCache::load.
+    ShaderProgram loadProgram(const std::string& vertexName, const std::string& fragmentName, const std::string& defines = "", const std::string& geometryName = "");
+    /**
+    * The prefilter program specialized for a roughness and sample count, built on the first request.
+    *
+    * \param float roughness The roughness of the level
+    * \param unsigned int sampleCount The number of samples, see sampleSchedule
+    * \param bool probeArray Whether the program renders probe batches from a cube map array
+    * \param std::string& name Receives a short name of the variant for the report
+    **/
+    const ShaderProgram& getPrefilterVariant(float roughness, unsigned int sampleCount, bool probeArray, std::string& name);
+    /**
+    * Renders the six faces of a prefiltered level and measures the GPU time.
+    *
+    * \param const ShaderProgram& shader The prefilter program
+    * \param unsigned int mip The level
+    * \param float roughness The roughness of the level, used if the program has no constant one
+    * \param const GLHandle& query The GL_TIME_ELAPSED query the draws are measured with
+    **/
+    void renderPrefilteredLevel(const ShaderProgram& shader, unsigned int mip, float roughness, const GLHandle& query);
+    /**
+    * Uploads the levels of the pending source which equiToCube.frag.glsl samples for the given face size into
+    * HDRsrcTexture and releases the pending source. Prints an error and throws if there is none.
+    *
+    * \param unsigned int faceSize The side width of the cube rendered from the source
+    **/
+    void uploadSourceLevels(unsigned int faceSize);
+    /**
+    * Binds captureFBO for rendering with a renderbuffer of the given size attached.
+    *
+    * \param int sideWidth The side width of the faces rendered next
+    **/
+    void bindCaptureFramebuffer(int sideWidth);
+    /**
+    * Takes a cube texture with undefined content from the pool and sets its sampling parameters.
+    *
+    * \param int sideWidth The side width of level 0
+    * \param unsigned int levels The number of levels. 0 creates the complete chain down to 1x1.
+    * \return The texture, it stays bound to GL_TEXTURE_CUBE_MAP
+    **/
+    GLHandle createCube(const int sideWidth, unsigned int levels);
+    /**
+    * Fills the mip chain of a cube texture from its level 0, either by the driver or by cubeMipBuilder.
+    *
+    * \param unsigned int cubeTexture The textures ID
+    * \param int sideWidth The side width of level 0
+    **/
+    void generateCubeMipmaps(const unsigned int cubeTexture, const int sideWidth);
+
+    /**
+    * Renders the cube faces through captureFBO and stores them into the given texture.
+    *
+    * \param const int sideWidth The images dimensions
+    * \param const unsigned int cubeTextures The cube texture ID where to render the images to.
+    * \param const ShaderProgram& shader The shader object to use for the cubes faces while rendering. It has to be current.
+    **/
+    void captureCubeFaces(const int sideWidth, const unsigned int cubeTexture, const ShaderProgram& shader);
+    /**
+    * Takes a cube map array with undefined content from the pool and sets its sampling parameters like createCube.
+    *
+    * \param int sideWidth The side width of level 0
+    * \param unsigned int levels The number of levels. 0 creates the complete chain down to 1x1.
+    * \param unsigned int probes The number of cubes
+    * \return The texture, it stays bound to GL_TEXTURE_CUBE_MAP_ARRAY
+    **/
+    GLHandle createCubeArray(const int sideWidth, unsigned int levels, unsigned int probes);
+    /**
+    * Binds probeFBO for rendering into all layers of a level of a cube map array at once.
+    *
+    * \param const GLHandle& cubeArray The texture
+    * \param unsigned int level The level
+    * \param int sideWidth The side width of the level
+    **/
+    void bindProbeFramebuffer(const GLHandle& cubeArray, unsigned int level, int sideWidth);
+    /// Renders the cube once per probe with a program using probe.geom.glsl, which picks the face and the layer.
+    void renderProbeCubes(unsigned int probes);
+    /// The texture ID of a product.
+    unsigned int getTexture(Product product) const;
+    /// The texture of a product.
+    GLHandle& getHandle(Product product);
+    /**
+    * Blits every face level of a cube into a new cube of another size.
+    *
+    * \param const GLHandle& cube The source cube
+    * \param int srcWidth The side width of level 0 of the source
+    * \param int sideWidth The side width of level 0 of the new cube
+    * \param unsigned int levels The number of levels to blit
+    * \param unsigned int allocatedLevels The number of levels of the new cube, 0 for the complete chain
+    * \return The new cube
+    **/
+    GLHandle blitCube(const GLHandle& cube, int srcWidth, int sideWidth, unsigned int levels, unsigned int allocatedLevels);
+
+    /// Helper to display a 2d texture.
+    void renderQuad();
+    /// Called every time a the cube has to be rendered to capture one of its faces.
+    void renderCube();
+    /// Creates cubeVAO and cubeVBO on the first call.
+    void initCubeVertices();
+};
+
+#endif // GLBACKEND_H
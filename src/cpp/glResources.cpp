@@ -0,0 +1,239 @@
+// Include own header
+#include "./glResources.h"
+// Include standard libraries
+#include <algorithm>
+#include <tuple>
+// Include own classes
+#include "./report.h"
+
+namespace {
+    /// The bytes of a texel of an internal format as the drivers commonly store it.
+    std::size_t bytesPerTexel(GLenum format) {
+        switch (format) {
+        case GL_RGB16F:
+            return 6;
+        case GL_RGBA16F:
+            return 8;
+        case GL_RGB32F:
+            return 12;
+        case GL_RGBA32F:
+            return 16;
+        default:
+            return 4;
+        }
+    }
+
+    GLHandle::Kind kindOf(GLenum target) {
+        return target == GL_RENDERBUFFER ? GLHandle::Kind::Renderbuffer : GLHandle::Kind::Texture;
+    }
+}
+
+bool GLResourceKey::operator<(const GLResourceKey& other) const {
+    return std::tie(this->target, this->width, this->height, this->format, this->levels, this->layers)
+        < std::tie(other.target, other.width, other.height, other.format, other.levels, other.layers);
+}
+
+std::size_t GLResourceKey::getBytes() const {
+    std::size_t texels = 0;
+    for (GLsizei level = 0; level < this->levels; ++level) {
+        texels += std::size_t(std::max(this->width >> level, 1)) * std::max(this->height >> level, 1);
+    }
+    const std::size_t faces = this->target == GL_TEXTURE_CUBE_MAP ? 6 : std::size_t(this->layers);
+    return texels * faces * bytesPerTexel(this->format);
+}
+
+GLHandle::GLHandle(Kind kind) : kind(kind) {
+    switch (kind) {
+    case Kind::Texture:
+        glGenTextures(1, &this->id);
+        break;
+    case Kind::Framebuffer:
+        glGenFramebuffers(1, &this->id);
+        break;
+    case Kind::Renderbuffer:
+        glGenRenderbuffers(1, &this->id);
+        break;
+    case Kind::Buffer:
+        glGenBuffers(1, &this->id);
+        break;
+    case Kind::VertexArray:
+        glGenVertexArrays(1, &this->id);
+        break;
+    case Kind::Query:
+        glGenQueries(1, &this->id);
+        break;
+    case Kind::Program:
+        this->id = glCreateProgram();
+        break;
+    }
+}
+
+GLHandle::~GLHandle() {
+    this->reset();
+}
+
+GLHandle::GLHandle(GLHandle&& other) : kind(other.kind), id(other.id), pool(other.pool), key(other.key) {
+    other.id = 0;
+    other.pool = nullptr;
+}
+
+GLHandle& GLHandle::operator=(GLHandle&& other) {
+    if (this != &other) {
+        this->reset();
+        this->kind = other.kind;
+        this->id = other.id;
+        this->pool = other.pool;
+        this->key = other.key;
+        other.id = 0;
+        other.pool = nullptr;
+    }
+    return *this;
+}
+
+GLuint GLHandle::get() const {
+    return this->id;
+}
+
+std::size_t GLHandle::getBytes() const {
+    return this->id != 0 && this->pool != nullptr ? this->key.getBytes() : 0;
+}
+
+void GLHandle::reset() {
+    if (this->id != 0) {
+        if (this->pool != nullptr) {
+            this->pool->giveBack(this->key, this->id);
+        }
+        else {
+            destroy(this->kind, this->id);
+        }
+    }
+    this->id = 0;
+    this->pool = nullptr;
+}
+
+void GLHandle::destroy(Kind kind, GLuint id) {
+    switch (kind) {
+    case Kind::Texture:
+        glDeleteTextures(1, &id);
+        break;
+    case Kind::Framebuffer:
+        glDeleteFramebuffers(1, &id);
+        break;
+    case Kind::Renderbuffer:
+        glDeleteRenderbuffers(1, &id);
+        break;
+    case Kind::Buffer:
+        glDeleteBuffers(1, &id);
+        break;
+    case Kind::VertexArray:
+        glDeleteVertexArrays(1, &id);
+        break;
+    case Kind::Query:
+        glDeleteQueries(1, &id);
+        break;
+    case Kind::Program:
+        glDeleteProgram(id);
+        break;
+    }
+}
+
+GLResourcePool::~GLResourcePool() {
+    this->clear();
+}
+
+GLHandle GLResourcePool::acquire(const GLResourceKey& key) {
+    this->requested.insert(key);
+    GLHandle handle;
+    handle.kind = kindOf(key.target);
+    handle.pool = this;
+    handle.key = key;
+    const std::size_t bytes = key.getBytes();
+    auto found = this->kept.find(key);
+    if (found != this->kept.end()) {
+        handle.id = found->second;
+        this->kept.erase(found);
+        this->keptBytes -= bytes;
+        this->usedBytes += bytes;
+        this->reused++;
+        if (key.target == GL_RENDERBUFFER) {
+            glBindRenderbuffer(GL_RENDERBUFFER, handle.id);
+        }
+        else {
+            glBindTexture(key.target, handle.id);
+        }
+        return handle;
+    }
+
+    if (key.target == GL_RENDERBUFFER) {
+        glGenRenderbuffers(1, &handle.id);
+        glBindRenderbuffer(GL_RENDERBUFFER, handle.id);
+        glRenderbufferStorage(GL_RENDERBUFFER, key.format, key.width, key.height);
+    }
+    else {
+        glGenTextures(1, &handle.id);
+        glBindTexture(key.target, handle.id);
+        // Immutable storage of exactly the requested levels, all faces and layers at once
+        if (key.target == GL_TEXTURE_2D_ARRAY || key.target == GL_TEXTURE_CUBE_MAP_ARRAY) {
+            glTexStorage3D(key.target, key.levels, key.format, key.width, key.height, key.layers);
+        }
+        else {
+            glTexStorage2D(key.target, key.levels, key.format, key.width, key.height);
+        }
+        glTexParameteri(key.target, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(key.target, GL_TEXTURE_MAX_LEVEL, key.levels - 1);
+    }
+    this->created++;
+    this->usedBytes += bytes;
+    this->peakBytes = std::max(this->peakBytes, this->usedBytes + this->keptBytes);
+    return handle;
+}
+
+void GLResourcePool::giveBack(const GLResourceKey& key, GLuint id) {
+    const std::size_t bytes = key.getBytes();
+    this->usedBytes -= bytes;
+    if (!this->keepReleased) {
+        GLHandle::destroy(kindOf(key.target), id);
+        return;
+    }
+    this->kept.insert(std::make_pair(key, id));
+    this->keptBytes += bytes;
+}
+
+template <typename Predicate>
+void GLResourcePool::remove(Predicate predicate) {
+    for (auto entry = this->kept.begin(); entry != this->kept.end();) {
+        if (predicate(entry->first)) {
+            GLHandle::destroy(kindOf(entry->first.target), entry->second);
+            this->keptBytes -= entry->first.getBytes();
+            entry = this->kept.erase(entry);
+        }
+        else {
+            ++entry;
+        }
+    }
+}
+
+void GLResourcePool::trim() {
+    remove([this](const GLResourceKey& key) { return this->requested.count(key) == 0; });
+    this->requested.clear();
+}
+
+void GLResourcePool::clear() {
+    remove([](const GLResourceKey&) { return true; });
+}
+
+void GLResourcePool::setKeepReleased(bool keepReleased) {
+    this->keepReleased = keepReleased;
+    if (!keepReleased) {
+        this->clear();
+    }
+}
+
+std::size_t GLResourcePool::getPeakBytes() const {
+    return this->peakBytes;
+}
+
+std::string GLResourcePool::describe() const {
+    return std::to_string(this->created) + " created, " + std::to_string(this->reused) + " reused, " + Report::formatBytes(this->usedBytes)
+        + " in use, " + Report::formatBytes(this->keptBytes) + " kept, peak " + Report::formatBytes(this->peakBytes);
+}
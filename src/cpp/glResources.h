@@ -0,0 +1,147 @@
+#ifndef GLRESOURCES_H
+#define GLRESOURCES_H
+
+// Include standard libraries
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+// Include glad for OpenGL function pointers
+#include "glad/glad.h"
+
+class GLResourcePool;
+
+/**
+* What a pooled texture or renderbuffer looks like. Objects with equal keys are interchangeable.
+**/
+struct GLResourceKey {
+    /// GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_CUBE_MAP_ARRAY or GL_RENDERBUFFER.
+    GLenum target = 0;
+    GLsizei width = 0;
+    GLsizei height = 0;
+    /// The internal format.
+    GLenum format = 0;
+    /// The number of mip levels, 1 for renderbuffers.
+    GLsizei levels = 1;
+    /// The layers of an array texture, six per cube of a cube map array. 1 for other targets.
+    GLsizei layers = 1;
+
+    GLResourceKey() {}
+    GLResourceKey(GLenum target, GLsizei width, GLsizei height, GLenum format, GLsizei levels, GLsizei layers = 1)
+        : target(target), width(width), height(height), format(format), levels(levels), layers(layers) {}
+
+    bool operator<(const GLResourceKey& other) const;
+    /// The estimated video memory of an object in bytes.
+    std::size_t getBytes() const;
+};
+
+/**
+* \class GLHandle
+*
+* \brief Owns an OpenGL object and deletes it when it goes out of scope.
+*
+* Handles of textures and renderbuffers from a GLResourcePool go back to the pool instead. The context the
+* object was created in has to be current when the handle is released.
+**/
+class GLHandle {
+public:
+    enum class Kind {Texture, Framebuffer, Renderbuffer, Buffer, VertexArray, Query, Program};
+
+    /// An empty handle.
+    GLHandle() {}
+    /// Generates a new object of the given kind.
+    explicit GLHandle(Kind kind);
+    ~GLHandle();
+
+    GLHandle(GLHandle&& other);
+    GLHandle& operator=(GLHandle&& other);
+    GLHandle(const GLHandle&) = delete;
+    GLHandle& operator=(const GLHandle&) = delete;
+
+    /// The object name, 0 if the handle is empty.
+    GLuint get() const;
+    /// Deletes the object or returns it to its pool. The handle is empty afterwards.
+    void reset();
+    /// The estimated video memory of a pooled object in bytes, 0 for other objects.
+    std::size_t getBytes() const;
+
+private:
+    friend class GLResourcePool;
+
+    Kind kind = Kind::Texture;
+    GLuint id = 0;
+    /// The pool the object returns to or nullptr.
+    GLResourcePool* pool = nullptr;
+    /// The key of a pooled object.
+    GLResourceKey key;
+
+    /// Deletes an object without asking the pool.
+    static void destroy(Kind kind, GLuint id);
+};
+
+/**
+* \class GLResourcePool
+*
+* \brief Hands out textures and renderbuffers with allocated storage and takes them back for reuse.
+*
+* Released objects are kept per GLResourceKey, so the next request with the same key gets one without a new
+* allocation. trim() deletes the kept objects of keys which were not requested since the previous trim, so a
+* process running job after job keeps a flat video memory use. The pool has to outlive its handles and has to
+* be cleared while its context is current.
+**/
+class GLResourcePool {
+public:
+    GLResourcePool() {}
+    /// Deletes the kept objects, see clear.
+    ~GLResourcePool();
+
+    GLResourcePool(const GLResourcePool&) = delete;
+    GLResourcePool& operator=(const GLResourcePool&) = delete;
+
+    /**
+    * A texture or renderbuffer with storage for all levels and undefined content. Textures have immutable storage
+    * (glTexStorage2D, glTexStorage3D for arrays), so their data is written with glTexSubImage2D or 3D or by rendering. Texture parameters are left as
+    * the previous user set them, apart from GL_TEXTURE_BASE_LEVEL and GL_TEXTURE_MAX_LEVEL which match the levels.
+    * The object stays bound to its target.
+    *
+    * \param const GLResourceKey& key What the object looks like
+    **/
+    GLHandle acquire(const GLResourceKey& key);
+    /// Deletes the kept objects of keys which were not requested since the previous call.
+    void trim();
+    /// Deletes all kept objects.
+    void clear();
+    /// Whether released objects are kept for reuse, on by default. Without it they are deleted right away.
+    void setKeepReleased(bool keepReleased);
+
+    /// A summary of the created and reused objects and the video memory for the report.
+    std::string describe() const;
+    /// The most video memory of handed out and kept objects at once in bytes.
+    std::size_t getPeakBytes() const;
+
+private:
+    friend class GLHandle;
+
+    /// Objects ready for reuse.
+    std::multimap<GLResourceKey, GLuint> kept;
+    /// The keys requested since the last trim.
+    std::set<GLResourceKey> requested;
+    std::size_t created = 0;
+    std::size_t reused = 0;
+    /// The memory of the handed out objects.
+    std::size_t usedBytes = 0;
+    /// The memory of the kept objects.
+    std::size_t keptBytes = 0;
+    /// The most memory of the pool at once.
+    std::size_t peakBytes = 0;
+    /// See setKeepReleased.
+    bool keepReleased = true;
+
+    /// Takes an object back, called by GLHandle::reset.
+    void giveBack(const GLResourceKey& key, GLuint id);
+    /// Deletes the kept objects a predicate selects.
+    template <typename Predicate>
+    void remove(Predicate predicate);
+};
+
+#endif // GLRESOURCES_H
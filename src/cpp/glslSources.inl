@@ -0,0 +1,388 @@
+// Generated by tools/embedGlsl.py from src/glsl, do not edit.
+// Included by shaderSources.cpp only.
+
+const EmbeddedSource embeddedSources[] = {
+    { "diffuseIBL.frag.glsl",
+        "#version 330 core\n"
+        "\n"
+        "/**\n"
+        "* This shader is originally from https://learnopengl.com\n"
+        "*\n"
+        "* With PROBE_ARRAY defined it renders a batch of probes, see probe.geom.glsl, from the cubes of an array.\n"
+        "**/\n"
+        "\n"
+        "#ifdef PROBE_ARRAY\n"
+        "#extension GL_ARB_texture_cube_map_array : require\n"
+        "#endif\n"
+        "\n"
+        "const float PI = 3.14159265359;\n"
+        "\n"
+        "out vec4 FragColor;\n"
+        "in vec3 localPos;\n"
+        "#ifdef PROBE_ARRAY\n"
+        "flat in int probe;\n"
+        "uniform samplerCubeArray environmentMap;\n"
+        "#define SAMPLE_ENVIRONMENT(direction) texture(environmentMap, vec4(direction, float(probe)))\n"
+        "#else\n"
+        "uniform samplerCube environmentMap;\n"
+        "#define SAMPLE_ENVIRONMENT(direction) texture(environmentMap, direction)\n"
+        "#endif\n"
+        "\n"
+        "void main(){\n"
+        "    // the sample direction equals the hemisphere's orientation \n"
+        "    vec3 normal = normalize(localPos);\n"
+        "    vec3 irradiance = vec3(0.0);\n"
+        "    vec3 up    = vec3(0.0, 1.0, 0.0);\n"
+        "    vec3 right = cross(up, normal);\n"
+        "    up         = cross(normal, right);\n"
+        "    float sampleDelta = 0.025;\n"
+        "    float nrSamples = 0.0;\n"
+        "    for(float phi = 0.0; phi < 2.0 * PI; phi += sampleDelta){\n"
+        "        for(float theta = 0.0; theta < 0.5 * PI; theta += sampleDelta){\n"
+        "            // spherical to cartesian (in tangent space)\n"
+        "            vec3 tangentSample = vec3(sin(theta) * cos(phi),  sin(theta) * sin(phi), cos(theta));\n"
+        "            // tangent space to world\n"
+        "            vec3 sampleVec = tangentSample.x * right + tangentSample.y * up + tangentSample.z * normal;\n"
+        "                irradiance += SAMPLE_ENVIRONMENT(sampleVec).rgb * cos(theta) * sin(theta);\n"
+        "                nrSamples++;\n"
+        "        }\n"
+        "    }\n"
+        "\n"
+        "    irradiance = PI * irradiance * (1.0 / float(nrSamples));\n"
+        "    FragColor = vec4(irradiance, 1.0);\n"
+        "}\n"
+    },
+    { "equiToCube.frag.glsl",
+        "#version 330 core\n"
+        "\n"
+        "/**\n"
+        "* This shader is originally from https://learnopengl.com\n"
+        "*\n"
+        "* With PROBE_ARRAY defined it renders a batch of probes, see probe.geom.glsl, and the sources are the layers of an array.\n"
+        "**/\n"
+        "\n"
+        "out vec4 FragColor;\n"
+        "in vec3 localPos;\n"
+        "\n"
+        "#ifdef PROBE_ARRAY\n"
+        "flat in int probe;\n"
+        "uniform sampler2DArray equirectangularMap;\n"
+        "#define SAMPLE_SOURCE(uv, lod) textureLod(equirectangularMap, vec3(uv, float(probe)), lod)\n"
+        "#else\n"
+        "uniform sampler2D equirectangularMap;\n"
+        "#define SAMPLE_SOURCE(uv, lod) textureLod(equirectangularMap, uv, lod)\n"
+        "#endif\n"
+        "uniform float faceSize;  // width and height of the rendered cube faces\n"
+        "uniform float srcHeight; // height of the equirectangular source at level 0\n"
+        "\n"
+        "const float PI = 3.14159265359;\n"
+        "\n"
+        "// 1 / (2 PI) and 1 / PI. Four digits put the seam side of a 16k source almost 3 texels off.\n"
+        "const vec2 invAtan = vec2(0.15915494, 0.31830989);\n"
+        "vec2 SampleSphericalMap(vec3 v)\n"
+        "{\n"
+        "    vec2 uv = vec2(atan(v.z, v.x), asin(v.y));\n"
+        "    uv *= invAtan;\n"
+        "    uv += 0.5;\n"
+        "    return uv;\n"
+        "}\n"
+        "\n"
+        "// The angular size of the current face texel. On the unit cube a texel covers the solid angle\n"
+        "// (2 / faceSize)^2 / |p|^3, the square root of it is the texels edge length on the sphere.\n"
+        "float TexelAngle(vec3 v)\n"
+        "{\n"
+        "    vec3 p = v / max(max(abs(v.x), abs(v.y)), abs(v.z));\n"
+        "    return 2.0 / faceSize * pow(dot(p, p), -0.75);\n"
+        "}\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    vec2 uv = SampleSphericalMap(normalize(localPos)); // make sure to normalize localPos\n"
+        "    // The source pyramid already compensates the horizontal stretching towards the poles,\n"
+        "    // so the LOD follows from the texel angle compared to the height of a source texel.\n"
+        "    float lod = max(log2(TexelAngle(localPos) * srcHeight / PI), 0.0);\n"
+        "    vec3 color = SAMPLE_SOURCE(uv, lod).rgb;\n"
+        "\n"
+        "    FragColor = vec4(color, 1.0);\n"
+        "}"
+    },
+    { "prefilterEnvIBL.frag.glsl",
+        "#version 330 core\n"
+        "\n"
+        "/**\n"
+        "* This shader is originally from https://learnopengl.com\n"
+        "*\n"
+        "* The loader specializes it per mip level by inserting defines after the version line:\n"
+        "* ROUGHNESS_ZERO   the level is a plain copy of the environment, no samples are taken\n"
+        "* ROUGHNESS [r]    the roughness is a constant instead of a uniform, so the compiler folds it\n"
+        "* SAMPLE_COUNT [n] the number of samples, default 8192u\n"
+        "* PROBE_ARRAY      a batch of probes is rendered, see probe.geom.glsl, from the cubes of an array\n"
+        "**/\n"
+        "\n"
+        "#ifdef PROBE_ARRAY\n"
+        "#extension GL_ARB_texture_cube_map_array : require\n"
+        "#endif\n"
+        "\n"
+        "#ifndef SAMPLE_COUNT\n"
+        "#define SAMPLE_COUNT 8192u\n"
+        "#endif\n"
+        "\n"
+        "out vec4 FragColor;\n"
+        "in vec3 localPos;\n"
+        "#ifdef PROBE_ARRAY\n"
+        "flat in int probe;\n"
+        "uniform samplerCubeArray environmentMap;\n"
+        "#define SAMPLE_ENVIRONMENT(direction, bias) texture(environmentMap, vec4(direction, float(probe)), bias)\n"
+        "#else\n"
+        "uniform samplerCube environmentMap;\n"
+        "#define SAMPLE_ENVIRONMENT(direction, bias) texture(environmentMap, direction, bias)\n"
+        "#endif\n"
+        "#ifdef ROUGHNESS\n"
+        "const float roughness = ROUGHNESS;\n"
+        "#else\n"
+        "uniform float roughness;\n"
+        "#endif\n"
+        "uniform float resolution; // resolution of source cubemap (per face)\n"
+        "\n"
+        "const float PI = 3.14159265359;\n"
+        "\n"
+        "\n"
+        "float DistributionGGX(float NdotH, float roughness)\n"
+        "{\n"
+        "    float a = roughness*roughness;\n"
+        "    float a2 = a*a;\n"
+        "    float NdotH2 = NdotH*NdotH;\n"
+        "    float nom   = a2;\n"
+        "    float denom = (NdotH2 * (a2 - 1.0) + 1.0);\n"
+        "    denom = PI * denom * denom;\n"
+        "    return nom / denom;\n"
+        "}\n"
+        "\n"
+        "\n"
+        "\n"
+        "float RadicalInverse_VdC(uint bits) \n"
+        "{\n"
+        "    bits = (bits << 16u) | (bits >> 16u);\n"
+        "    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);\n"
+        "    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);\n"
+        "    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);\n"
+        "    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);\n"
+        "    return float(bits) * 2.3283064365386963e-10;\n"
+        "    // / 0x100000000\n"
+        "}\n"
+        "\n"
+        "vec2 Hammersley(uint i, uint N)\n"
+        "{\n"
+        "    return vec2(float(i)/float(N), RadicalInverse_VdC(i));\n"
+        "}\n"
+        "\n"
+        "\n"
+        "\n"
+        "vec3 ImportanceSampleGGX(vec2 Xi, vec3 N, float roughness)\n"
+        "{\n"
+        "    float a = roughness*roughness*roughness*roughness;\n"
+        "    float phi = 2.0 * PI * Xi.x;\n"
+        "    float cosTheta = sqrt((1.0 - Xi.y) / (1.0 + (a - 1.0) * Xi.y));\n"
+        "    float sinTheta = sqrt(1.0 - cosTheta*cosTheta);\n"
+        "    // from spherical coordinates to cartesian coordinates\n"
+        "    vec3 H;\n"
+        "    H.x = cos(phi) * sinTheta;\n"
+        "    H.y = sin(phi) * sinTheta;\n"
+        "    H.z = cosTheta;\n"
+        "    // from tangent-space vector to world-space sample vector\n"
+        "    vec3 up        = abs(N.z) < 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(1.0, 0.0, 0.0);\n"
+        "    vec3 tangent   = normalize(cross(up, N));\n"
+        "    vec3 bitangent = cross(N, tangent);\n"
+        "    vec3 sampleVec = tangent * H.x + bitangent * H.y + N * H.z;\n"
+        "    return normalize(sampleVec);\n"
+        "}\n"
+        "\n"
+        "\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    vec3 N = normalize(localPos);\n"
+        "#ifdef ROUGHNESS_ZERO\n"
+        "    // Every sample would be the reflection itself with a mip bias of 0\n"
+        "    FragColor = vec4(SAMPLE_ENVIRONMENT(N, 0.0).rgb, 1.0);\n"
+        "#else\n"
+        "    vec3 R = N;\n"
+        "    vec3 V = R;\n"
+        "    float totalWeight = 0.0;\n"
+        "    vec3 prefilteredColor = vec3(0.0);\n"
+        "    for(uint i = 0u; i < SAMPLE_COUNT; ++i)\n"
+        "    {\n"
+        "        vec2 Xi = Hammersley(i, SAMPLE_COUNT);\n"
+        "        vec3 H  = ImportanceSampleGGX(Xi, N, roughness);\n"
+        "        vec3 L  = normalize(2.0 * dot(V, H) * H - V);\n"
+        "        float NdotH = max(dot(N, H), 0.0);\n"
+        "        float HdotV = max(dot(H, V), 0.0);\n"
+        "        float NdotL = max(dot(N, L), 0.0);\n"
+        "        if(NdotL > 0.0)\n"
+        "        {\n"
+        "            float D   = DistributionGGX(NdotH, roughness);\n"
+        "            float pdf = (D * NdotH / (4.0 * HdotV)) + 0.0001;\n"
+        "            float saTexel  = 4.0 * PI / (6.0 * resolution * resolution);\n"
+        "            float saSample = 1.0 / (float(SAMPLE_COUNT) * pdf + 0.0001);\n"
+        "            float mipLevel = 0.0;\n"
+        "            if(roughness != 0.0){\n"
+        "                mipLevel = 0.5 * log2(saSample / saTexel);\n"
+        "            }\n"
+        "\n"
+        "            prefilteredColor += SAMPLE_ENVIRONMENT(L, mipLevel).rgb * NdotL;\n"
+        "            totalWeight      += NdotL;\n"
+        "        }\n"
+        "\n"
+        "    }\n"
+        "    prefilteredColor = prefilteredColor / totalWeight;\n"
+        "    FragColor = vec4(prefilteredColor, 1.0);\n"
+        "#endif\n"
+        "}"
+    },
+    { "probe.geom.glsl",
+        "#version 430 core\n"
+        "\n"
+        "// One invocation per cube face, so a single instanced draw renders every face of every probe of a batch\n"
+        "layout (triangles, invocations = 6) in;\n"
+        "layout (triangle_strip, max_vertices = 3) out;\n"
+        "\n"
+        "// Uploaded once per context, shared by all programs rendering cube faces\n"
+        "layout (std140) uniform Capture\n"
+        "{\n"
+        "    mat4 projection;\n"
+        "    mat4 views[6];\n"
+        "};\n"
+        "\n"
+        "in vec3 vertexPos[];\n"
+        "flat in int vertexProbe[];\n"
+        "\n"
+        "out vec3 localPos;\n"
+        "flat out int probe;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    for (int i = 0; i < 3; ++i)\n"
+        "    {\n"
+        "        localPos = vertexPos[i];\n"
+        "        probe = vertexProbe[0];\n"
+        "        // The layers of a cube map array are the faces of one cube after the other\n"
+        "        gl_Layer = vertexProbe[0] * 6 + gl_InvocationID;\n"
+        "        gl_Position = projection * views[gl_InvocationID] * vec4(localPos, 1.0);\n"
+        "        EmitVertex();\n"
+        "    }\n"
+        "    EndPrimitive();\n"
+        "}\n"
+    },
+    { "probe.vert.glsl",
+        "#version 430 core\n"
+        "\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "\n"
+        "// The geometry shader projects the cube once per face\n"
+        "out vec3 vertexPos;\n"
+        "flat out int vertexProbe;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    vertexPos = aPos;\n"
+        "    // One instance per probe of the batch\n"
+        "    vertexProbe = gl_InstanceID;\n"
+        "}\n"
+    },
+    { "simpleSkybox.frag.glsl",
+        "#version 330 core\n"
+        "\n"
+        "out vec4 FragColor;\n"
+        "in vec3 WorldPos;\n"
+        "uniform samplerCube environmentMap;\n"
+        "void main()\n"
+        "{\n"
+        "    vec3 envColor = texture(environmentMap, WorldPos).rgb;\n"
+        "    // HDR tonemap and gamma correct\n"
+        "    envColor = envColor / (envColor + vec3(1.0));\n"
+        "    envColor = pow(envColor, vec3(1.0/2.2));\n"
+        "    FragColor = vec4(envColor, 1.0);\n"
+        "}\n"
+    },
+    { "simpleSkybox.vert.glsl",
+        "#version 330 core\n"
+        "\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "uniform mat4 projection;\n"
+        "uniform mat4 view;\n"
+        "out vec3 WorldPos;\n"
+        "void main()\n"
+        "{\n"
+        "    WorldPos = aPos;\n"
+        "    mat4 rotView = mat4(mat3(view));\n"
+        "    vec4 clipPos = projection * rotView * vec4(WorldPos, 1.0);\n"
+        "    gl_Position = clipPos.xyww;\n"
+        "}\n"
+    },
+    { "std.vert.glsl",
+        "#version 330 core\n"
+        "\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "\n"
+        "out vec3 localPos;\n"
+        "\n"
+        "// Uploaded once per context, shared by all programs rendering cube faces\n"
+        "layout (std140) uniform Capture\n"
+        "{\n"
+        "    mat4 projection;\n"
+        "    mat4 views[6];\n"
+        "};\n"
+        "// The cube face rendered, indexes views\n"
+        "uniform int face;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    localPos = aPos;\n"
+        "    gl_Position =  projection * views[face] * vec4(localPos, 1.0);\n"
+        "}\n"
+    },
+    { "stdYFlip.vert.glsl",
+        "#version 330 core\n"
+        "\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "\n"
+        "out vec3 localPos;\n"
+        "\n"
+        "uniform mat4 projection;\n"
+        "uniform mat4 view;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    localPos = vec3(aPos.x, -aPos.y, aPos.z);\n"
+        "    gl_Position =  projection * view * vec4(localPos, 1.0);\n"
+        "}\n"
+    },
+    { "texturedPlane.frag.glsl",
+        "#version 330 core\n"
+        "\n"
+        "out vec4 FragColor;\n"
+        "  \n"
+        "in vec2 TexCoord;\n"
+        "\n"
+        "uniform sampler2D ourTexture;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    FragColor = texture(ourTexture, TexCoord);\n"
+        "}"
+    },
+    { "texturedPlane.vert.glsl",
+        "#version 330 core\n"
+        "\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "layout (location = 1) in vec2 aTexCoord;\n"
+        "\n"
+        "out vec2 TexCoord;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    gl_Position = vec4(aPos, 1.0);\n"
+        "    TexCoord = aTexCoord;\n"
+        "}\n"
+    },
+};
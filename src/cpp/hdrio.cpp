@@ -0,0 +1,326 @@
+// Include own header
+#include "./hdrio.h"
+// Include standard libraries
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    /// The largest width and height a file may claim. Sources come from clients of -serve, the header must not be
+    /// able to wrap the buffer sizes around.
+    const unsigned int maxDimension = 1u << 17;
+
+    /// Converts one RGBE pixel to float RGB. Same conversion as the reference rgbe.c by Bruce Walter.
+    inline void rgbeToFloat(const unsigned char* rgbe, float* rgb) {
+        if (rgbe[3] == 0) {
+            rgb[0] = rgb[1] = rgb[2] = 0.0f;
+            return;
+        }
+        const float f = std::ldexp(1.0f, int(rgbe[3]) - (128 + 8));
+        rgb[0] = rgbe[0] * f;
+        rgb[1] = rgbe[1] * f;
+        rgb[2] = rgbe[2] * f;
+    }
+
+    /// Converts one float RGB pixel to RGBE.
+    inline void floatToRgbe(const float* rgb, unsigned char* rgbe) {
+        float v = rgb[0];
+        if (rgb[1] > v) v = rgb[1];
+        if (rgb[2] > v) v = rgb[2];
+        if (v < 1e-32f) {
+            rgbe[0] = rgbe[1] = rgbe[2] = rgbe[3] = 0;
+            return;
+        }
+        int e;
+        v = std::frexp(v, &e) * 256.0f / v;
+        rgbe[0] = (unsigned char)(rgb[0] > 0.0f ? rgb[0] * v : 0.0f);
+        rgbe[1] = (unsigned char)(rgb[1] > 0.0f ? rgb[1] * v : 0.0f);
+        rgbe[2] = (unsigned char)(rgb[2] > 0.0f ? rgb[2] * v : 0.0f);
+        rgbe[3] = (unsigned char)(e + 128);
+    }
+
+    /// Numbers the writers of the process, see temporaryPathFor.
+    std::atomic<unsigned long> writerCount(0);
+
+    /// A temporary name next to the path which no other writer uses, also not one of a parallel job of -serve.
+    std::string temporaryPathFor(const std::string& path) {
+#ifdef _WIN32
+        const long pid = _getpid();
+#else
+        const long pid = getpid();
+#endif
+        return path + "." + std::to_string(pid) + "." + std::to_string(writerCount++) + ".tmp";
+    }
+
+    /// Reads a single header line without the line break. Returns false on EOF.
+    bool readLine(std::FILE* file, std::string& line) {
+        line.clear();
+        int c;
+        while ((c = std::fgetc(file)) != EOF) {
+            if (c == '\n') {
+                return true;
+            }
+            line.push_back((char)c);
+        }
+        return !line.empty();
+    }
+}
+
+HdrReader::HdrReader(const std::string& path) {
+    try {
+        this->file = std::fopen(path.c_str(), "rb");
+        if (this->file == nullptr) {
+            throw(1);
+        }
+        std::string line;
+        if (!readLine(this->file, line) || (line.compare(0, 10, "#?RADIANCE") != 0 && line.compare(0, 6, "#?RGBE") != 0)) {
+            throw(2);
+        }
+        // Header variables end with an empty line
+        while (readLine(this->file, line) && !line.empty()) {
+            if (line.compare(0, 7, "FORMAT=") == 0 && line != "FORMAT=32-bit_rle_rgbe") {
+                throw(2);
+            }
+        }
+        // Only the standard orientation is supported: top to bottom, left to right
+        if (!readLine(this->file, line) || std::sscanf(line.c_str(), "-Y %u +X %u", &this->height, &this->width) != 2 ||
+            this->width > maxDimension || this->height > maxDimension) {
+            throw(2);
+        }
+    }
+    catch (int eCode) {
+        if (eCode == 1) {
+            std::cout << "ERROR: Could not open: " << path << std::endl;
+        }
+        else if (eCode == 2) {
+            std::cout << "ERROR: Unsupported hdr file: " << path << std::endl;
+        }
+        if (this->file != nullptr) {
+            std::fclose(this->file);
+        }
+        throw(eCode);
+    }
+    this->rgbe.resize(std::size_t(this->width) * 4);
+}
+
+HdrReader::~HdrReader() {
+    std::fclose(this->file);
+}
+
+unsigned int HdrReader::getWidth() const {
+    return this->width;
+}
+
+unsigned int HdrReader::getHeight() const {
+    return this->height;
+}
+
+unsigned int HdrReader::getNextRow() const {
+    return this->nextRow;
+}
+
+bool HdrReader::readScanline(float* rgb) {
+    if (this->nextRow >= this->height) {
+        return false;
+    }
+    unsigned char first[4];
+    if (std::fread(first, 1, 4, this->file) != 4) {
+        return false;
+    }
+    bool ok;
+    // New style RLE is only possible for widths between 8 and 32767
+    if (this->width >= 8 && this->width < 32768 && first[0] == 2 && first[1] == 2 && (first[2] & 0x80) == 0) {
+        ok = ((unsigned int)first[2] << 8 | first[3]) == this->width && this->readRleScanline();
+    }
+    else {
+        ok = this->readFlatScanline(first);
+    }
+    if (!ok) {
+        std::cout << "ERROR: Corrupt hdr scanline: " << this->nextRow << std::endl;
+        return false;
+    }
+    for (unsigned int x = 0; x < this->width; ++x) {
+        rgbeToFloat(&this->rgbe[x * 4], &rgb[x * 3]);
+    }
+    this->nextRow++;
+    return true;
+}
+
+bool HdrReader::readFlatScanline(const unsigned char first[4]) {
+    unsigned char pixel[4] = { first[0], first[1], first[2], first[3] };
+    unsigned int x = 0;
+    int shift = 0;
+    while (true) {
+        if (pixel[0] == 1 && pixel[1] == 1 && pixel[2] == 1) {
+            // Old style RLE: repeat the previous pixel. Every further run pixel adds 8 bits to the count, from 24 bits on
+            // it would overflow and no valid width needs that many.
+            if (shift >= 24) {
+                return false;
+            }
+            const unsigned int count = (unsigned int)pixel[3] << shift;
+            if (x == 0 || x + count > this->width) {
+                return false;
+            }
+            for (unsigned int i = 0; i < count; ++i, ++x) {
+                std::memcpy(&this->rgbe[x * 4], &this->rgbe[(x - 1) * 4], 4);
+            }
+            shift += 8;
+        }
+        else {
+            std::memcpy(&this->rgbe[x * 4], pixel, 4);
+            x++;
+            shift = 0;
+        }
+        if (x >= this->width) {
+            return true;
+        }
+        if (std::fread(pixel, 1, 4, this->file) != 4) {
+            return false;
+        }
+    }
+}
+
+bool HdrReader::readRleScanline() {
+    // The four channels are stored one after another
+    for (unsigned int c = 0; c < 4; ++c) {
+        unsigned int x = 0;
+        while (x < this->width) {
+            int count = std::fgetc(this->file);
+            if (count == EOF) {
+                return false;
+            }
+            if (count > 128) {
+                count -= 128;
+                const int value = std::fgetc(this->file);
+                if (value == EOF || x + count > this->width) {
+                    return false;
+                }
+                for (int i = 0; i < count; ++i, ++x) {
+                    this->rgbe[x * 4 + c] = (unsigned char)value;
+                }
+            }
+            else {
+                if (count == 0 || x + count > this->width) {
+                    return false;
+                }
+                for (int i = 0; i < count; ++i, ++x) {
+                    const int value = std::fgetc(this->file);
+                    if (value == EOF) {
+                        return false;
+                    }
+                    this->rgbe[x * 4 + c] = (unsigned char)value;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+HdrWriter::HdrWriter(const std::string& path, unsigned int width, unsigned int height) : path(path), temporaryPath(temporaryPathFor(path)) {
+    this->file = std::fopen(this->temporaryPath.c_str(), "wb");
+    if (this->file == nullptr) {
+        std::cout << "ERROR: Could not create: " << this->temporaryPath << std::endl;
+        throw(1);
+    }
+    this->width = width;
+    this->rgbe.resize(std::size_t(width) * 4);
+    this->packed.reserve(width + width / 128 + 2);
+    std::fprintf(this->file, "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y %u +X %u\n", height, width);
+}
+
+HdrWriter::~HdrWriter() {
+    if (this->committed) {
+        return;
+    }
+    if (this->file != nullptr) {
+        std::fclose(this->file);
+    }
+    std::remove(this->temporaryPath.c_str());
+}
+
+void HdrWriter::commit() {
+    const bool written = std::ferror(this->file) == 0;
+    const bool closed = std::fclose(this->file) == 0;
+    this->file = nullptr;
+    if (!written || !closed) {
+        std::cout << "ERROR: Could not write: " << this->temporaryPath << std::endl;
+        std::remove(this->temporaryPath.c_str());
+        throw(1);
+    }
+    // Both replace an existing file in one step on the same volume
+#ifdef _WIN32
+    const bool moved = MoveFileExA(this->temporaryPath.c_str(), this->path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    const bool moved = std::rename(this->temporaryPath.c_str(), this->path.c_str()) == 0;
+#endif
+    if (!moved) {
+        std::cout << "ERROR: Could not replace: " << this->path << std::endl;
+        std::remove(this->temporaryPath.c_str());
+        throw(1);
+    }
+    this->committed = true;
+}
+
+void HdrWriter::writeScanline(const float* rgb) {
+    for (unsigned int x = 0; x < this->width; ++x) {
+        floatToRgbe(&rgb[x * 3], &this->rgbe[x * 4]);
+    }
+    if (this->width < 8 || this->width >= 32768) {
+        std::fwrite(this->rgbe.data(), 1, this->rgbe.size(), this->file);
+        return;
+    }
+    const unsigned char header[4] = { 2, 2, (unsigned char)(this->width >> 8), (unsigned char)(this->width & 0xFF) };
+    std::fwrite(header, 1, 4, this->file);
+    // Encode every channel on its own. Runs shorter than 4 bytes are stored as literals.
+    for (unsigned int c = 0; c < 4; ++c) {
+        this->packed.clear();
+        unsigned int cur = 0;
+        while (cur < this->width) {
+            unsigned int begRun = cur;
+            unsigned int runCount = 0;
+            unsigned int oldRunCount = 0;
+            while (runCount < 4 && begRun < this->width) {
+                begRun += runCount;
+                oldRunCount = runCount;
+                runCount = 1;
+                while (begRun + runCount < this->width && runCount < 127 &&
+                    this->rgbe[begRun * 4 + c] == this->rgbe[(begRun + runCount) * 4 + c]) {
+                    runCount++;
+                }
+            }
+            // A short run right before the long one
+            if (oldRunCount > 1 && oldRunCount == begRun - cur) {
+                this->packed.push_back((unsigned char)(128 + oldRunCount));
+                this->packed.push_back(this->rgbe[cur * 4 + c]);
+                cur = begRun;
+            }
+            // Literal bytes up to the start of the run
+            while (cur < begRun) {
+                unsigned int nonRun = begRun - cur;
+                if (nonRun > 128) {
+                    nonRun = 128;
+                }
+                this->packed.push_back((unsigned char)nonRun);
+                for (unsigned int i = 0; i < nonRun; ++i) {
+                    this->packed.push_back(this->rgbe[(cur + i) * 4 + c]);
+                }
+                cur += nonRun;
+            }
+            if (runCount >= 4) {
+                this->packed.push_back((unsigned char)(128 + runCount));
+                this->packed.push_back(this->rgbe[begRun * 4 + c]);
+                cur += runCount;
+            }
+        }
+        std::fwrite(this->packed.data(), 1, this->packed.size(), this->file);
+    }
+}
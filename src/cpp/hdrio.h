@@ -0,0 +1,128 @@
+#ifndef HDRIO_H
+#define HDRIO_H
+
+// Include standard libraries
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+* \class HdrReader
+*
+* Reads a Radiance .hdr (RGBE) file scanline by scanline.
+*
+* Decoding the complete image into memory at once is not affordable for very large equirectangular sources, so
+* this reader only keeps one encoded scanline at a time and hands out decoded float RGB rows
+* in file order (top row first). Flat, old style RLE and new style RLE scanlines are supported.
+**/
+class HdrReader {
+public:
+    /**
+    * \brief Opens the file and parses the header.
+    *
+    * Prints an error and throws if the file can not be opened or is no supported .hdr file, which includes sizes
+    * above 131072 pixels per side.
+    *
+    * \param std::string& The path of the .hdr file
+    **/
+    HdrReader(const std::string&);
+    /// Closes the file.
+    ~HdrReader();
+
+    HdrReader(const HdrReader&) = delete;
+    HdrReader& operator=(const HdrReader&) = delete;
+
+    /// The images width in pixels.
+    unsigned int getWidth() const;
+    /// The images height in pixels.
+    unsigned int getHeight() const;
+    /// Index of the next scanline readScanline() returns. Row 0 is the top row of the image.
+    unsigned int getNextRow() const;
+
+    /**
+    * Decodes the next scanline.
+    *
+    * \param float* rgb Destination for width * 3 floats.
+    * \return false if there are no rows left or the data is corrupt.
+    **/
+    bool readScanline(float* rgb);
+
+private:
+    /// The opened file.
+    std::FILE* file = nullptr;
+    /// The images width in pixels.
+    unsigned int width = 0;
+    /// The images height in pixels.
+    unsigned int height = 0;
+    /// The next row to read.
+    unsigned int nextRow = 0;
+    /// The encoded RGBE bytes of the current scanline.
+    std::vector<unsigned char> rgbe;
+
+    /// Reads a scanline without the new style RLE header into rgbe. The first pixel is already read.
+    bool readFlatScanline(const unsigned char first[4]);
+    /// Reads a new style RLE scanline into rgbe.
+    bool readRleScanline();
+};
+
+/**
+* \class HdrWriter
+*
+* Writes a Radiance .hdr (RGBE) file scanline by scanline, top row first.
+* Scanlines are new style RLE encoded if the width allows it and flat otherwise.
+*
+* The file is written under a temporary name next to the path, unique per writer so parallel jobs with the same
+* output do not share it. commit() moves it over the path after the last scanline, so a reader sees either the
+* previous file or the complete new one, never a partly written one. A writer destroyed without commit(), e.g.
+* while an exception unwinds, deletes the temporary file and leaves the path alone.
+**/
+class HdrWriter {
+public:
+    /**
+    * \brief Creates the file and writes the header.
+    *
+    * Prints an error and throws if the file can not be created.
+    *
+    * \param std::string& The path of the .hdr file
+    * \param unsigned int width The images width
+    * \param unsigned int height The images height
+    **/
+    HdrWriter(const std::string&, unsigned int width, unsigned int height);
+    /// Closes and deletes the temporary file unless commit() replaced the path with it.
+    ~HdrWriter();
+
+    HdrWriter(const HdrWriter&) = delete;
+    HdrWriter& operator=(const HdrWriter&) = delete;
+
+    /**
+    * Encodes and writes the next scanline.
+    *
+    * \param const float* rgb width * 3 floats.
+    **/
+    void writeScanline(const float* rgb);
+
+    /**
+    * Closes the file and replaces the path with it. Call it after the last scanline.
+    *
+    * Prints an error, deletes the temporary file and throws if a write failed or the path can not be replaced.
+    **/
+    void commit();
+
+private:
+    /// The opened file.
+    std::FILE* file = nullptr;
+    /// The path the file replaces when it is complete.
+    std::string path;
+    /// The path the file is written to.
+    std::string temporaryPath;
+    /// Whether commit() moved the file over the path.
+    bool committed = false;
+    /// The images width in pixels.
+    unsigned int width = 0;
+    /// Encoding buffer for one scanline.
+    std::vector<unsigned char> rgbe;
+    /// Encoding buffer for one RLE channel.
+    std::vector<unsigned char> packed;
+};
+
+#endif // HDRIO_H
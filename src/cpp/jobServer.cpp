@@ -0,0 +1,285 @@
+// Include own header
+#include "./jobServer.h"
+// Include standard libraries
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#define poll WSAPoll
+#define closeSocket closesocket
+typedef SOCKET SocketHandle;
+#else
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define closeSocket close
+typedef int SocketHandle;
+#endif
+
+namespace {
+    /// How often the threads look for a stop request.
+    const int pollMs = 200;
+    /// How long a client may take to send its request.
+    const int requestTimeoutMs = 5000;
+    /// The most connections whose request is still being read, further ones are closed right away.
+    const std::size_t maxPendingRequests = 64;
+
+    std::atomic<bool> stopRequested(false);
+
+    void onSignal(int) {
+        stopRequested = true;
+    }
+
+    bool sendLine(std::intptr_t connection, const std::string& line) {
+        const std::string text = line + "\n";
+        std::size_t sent = 0;
+        while (sent < text.size()) {
+            const int count = (int)send((SocketHandle)connection, text.data() + sent, (int)(text.size() - sent), 0);
+            if (count <= 0) {
+                return false;
+            }
+            sent += count;
+        }
+        return true;
+    }
+
+    /// A connection whose request line is not complete yet.
+    struct PendingRequest {
+        std::intptr_t connection;
+        std::string line;
+        Timer connected;
+    };
+
+    /**
+    * Reads what a connection has sent so far without blocking.
+    *
+    * \return 1 if the request line is complete, 0 if it is not yet, -1 if the client went away or sent too much
+    **/
+    int receive(PendingRequest& request) {
+        char buffer[4096];
+        const int count = (int)recv((SocketHandle)request.connection, buffer, sizeof(buffer), 0);
+        if (count <= 0) {
+            return -1;
+        }
+        request.line.append(buffer, count);
+        const std::size_t end = request.line.find('\n');
+        if (end == std::string::npos) {
+            return request.line.size() < 65536 ? 0 : -1;
+        }
+        // A client sends one line, anything after it is ignored
+        request.line.resize(end);
+        if (!request.line.empty() && request.line.back() == '\r') {
+            request.line.pop_back();
+        }
+        return 1;
+    }
+}
+
+JobServer::JobServer(const std::string& socketPath, std::size_t capacity) : socketPath(socketPath), capacity(capacity) {}
+
+JobServer::~JobServer() {
+    stopRequested = true;
+    if (this->acceptThread.joinable()) {
+        this->acceptThread.join();
+    }
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (Job& job : this->queue) {
+        closeSocket((SocketHandle)job.connection);
+    }
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool JobServer::start() {
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        std::cout << "ERROR: Winsock is not available" << std::endl;
+        return false;
+    }
+#else
+    // A client which goes away must not end the server
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (this->socketPath.size() >= sizeof(address.sun_path)) {
+        std::cout << "ERROR: Socket path too long: " << this->socketPath << std::endl;
+        return false;
+    }
+    std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", this->socketPath.c_str());
+    // A socket file left by a previous server blocks bind
+    std::remove(this->socketPath.c_str());
+
+    const SocketHandle listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener == (SocketHandle)-1 || bind(listener, (const sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 16) != 0) {
+        std::cout << "ERROR: Could not listen on: " << this->socketPath << std::endl;
+        if (listener != (SocketHandle)-1) {
+            closeSocket(listener);
+        }
+        return false;
+    }
+    this->listener = (std::intptr_t)listener;
+    stopRequested = false;
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGINT, onSignal);
+    this->acceptThread = std::thread(&JobServer::acceptLoop, this);
+    return true;
+}
+
+void JobServer::acceptLoop() {
+    // The requests are read as they arrive, so a slow client does not hold up the others
+    std::vector<PendingRequest> pending;
+    std::vector<pollfd> descriptors;
+    while (!stopRequested) {
+        descriptors.assign(1, pollfd{ (SocketHandle)this->listener, POLLIN, 0 });
+        for (const PendingRequest& request : pending) {
+            descriptors.push_back(pollfd{ (SocketHandle)request.connection, POLLIN, 0 });
+        }
+        if (poll(descriptors.data(), (unsigned int)descriptors.size(), pollMs) < 0) {
+            continue;
+        }
+        std::vector<PendingRequest> waiting;
+        for (std::size_t i = 0; i < pending.size(); ++i) {
+            PendingRequest& request = pending[i];
+            const int state = descriptors[i + 1].revents != 0 ? receive(request) : 0;
+            if (state == 1) {
+                this->handle(request.connection, request.line);
+            }
+            else if (state < 0 || request.connected.elapsedMs() > requestTimeoutMs) {
+                closeSocket((SocketHandle)request.connection);
+            }
+            else {
+                waiting.push_back(std::move(request));
+            }
+        }
+        pending.swap(waiting);
+        if ((descriptors[0].revents & POLLIN) != 0) {
+            const SocketHandle connection = accept((SocketHandle)this->listener, nullptr, nullptr);
+            if (connection != (SocketHandle)-1 && pending.size() < maxPendingRequests) {
+                pending.push_back(PendingRequest{ (std::intptr_t)connection, std::string(), Timer() });
+            }
+            else if (connection != (SocketHandle)-1) {
+                closeSocket(connection);
+            }
+        }
+    }
+    for (const PendingRequest& request : pending) {
+        closeSocket((SocketHandle)request.connection);
+    }
+    // No new jobs during the drain
+    closeSocket((SocketHandle)this->listener);
+    std::remove(this->socketPath.c_str());
+    this->available.notify_all();
+}
+
+void JobServer::handle(std::intptr_t connection, const std::string& line) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (line == "status") {
+        std::ostringstream status;
+        status << "status queued " << this->queue.size() << " running ";
+        for (std::size_t i = 0; i < this->running.size(); ++i) {
+            status << (i > 0 ? "," : "") << this->running[i];
+        }
+        status << (this->running.empty() ? "none" : "") << " finished " << this->finished;
+        lock.unlock();
+        sendLine(connection, status.str());
+        closeSocket((SocketHandle)connection);
+        return;
+    }
+    Job job;
+    job.args = split(line);
+    if (job.args.empty() || this->queue.size() >= this->capacity) {
+        lock.unlock();
+        sendLine(connection, job.args.empty() ? "rejected empty request" : "rejected queue full");
+        closeSocket((SocketHandle)connection);
+        return;
+    }
+    job.id = this->nextId++;
+    job.connection = connection;
+    sendLine(connection, "queued " + std::to_string(job.id) + " position " + std::to_string(this->queue.size() + 1));
+    this->queue.push_back(std::move(job));
+    lock.unlock();
+    this->available.notify_one();
+}
+
+bool JobServer::next(Job& job) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (this->queue.empty()) {
+        if (stopRequested) {
+            return false;
+        }
+        this->available.wait_for(lock, std::chrono::milliseconds(pollMs));
+    }
+    job = std::move(this->queue.front());
+    this->queue.pop_front();
+    this->running.push_back(job.id);
+    lock.unlock();
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1) << "running " << job.id << " waited " << job.queued.elapsedMs() << " ms";
+    this->reply(job, line.str());
+    return true;
+}
+
+void JobServer::reply(const Job& job, const std::string& line) const {
+    sendLine(job.connection, line);
+}
+
+void JobServer::finish(Job& job, bool ok, double ms, const Report& report) {
+    std::stringstream lines;
+    report.print(lines);
+    std::string line;
+    while (std::getline(lines, line)) {
+        this->reply(job, "report " + line);
+    }
+    std::ostringstream result;
+    result << std::fixed << std::setprecision(1) << "done " << job.id << (ok ? " ok " : " failed ") << ms << " ms";
+    this->reply(job, result.str());
+    closeSocket((SocketHandle)job.connection);
+    job.connection = -1;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->running.erase(std::remove(this->running.begin(), this->running.end(), job.id), this->running.end());
+    this->finished++;
+}
+
+bool JobServer::isStopRequested() {
+    return stopRequested;
+}
+
+std::vector<std::string> JobServer::split(const std::string& line) {
+    std::vector<std::string> args;
+    std::string arg;
+    bool quoted = false;
+    bool started = false;
+    for (char c : line) {
+        if (c == '"') {
+            quoted = !quoted;
+            started = true;
+        }
+        else if ((c == ' ' || c == '\t') && !quoted) {
+            if (started) {
+                args.push_back(arg);
+            }
+            arg.clear();
+            started = false;
+        }
+        else {
+            arg += c;
+            started = true;
+        }
+    }
+    if (started) {
+        args.push_back(arg);
+    }
+    return args;
+}
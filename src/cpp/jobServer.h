@@ -0,0 +1,117 @@
+#ifndef JOBSERVER_H
+#define JOBSERVER_H
+
+// Include standard libraries
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+// Include own classes
+#include "./report.h"
+
+/**
+* \class JobServer
+*
+* \brief Accepts jobs over a Unix domain socket for a long running process with a warm Generator.
+*
+* A client connects and sends one line: either "status", or the input path followed by the parameters of the command
+* line, separated by spaces, with double quotes around arguments containing spaces. A job is answered with
+* "queued <id> position <n>", or with "rejected queue full" if the bounded queue has no room. The connection stays
+* open: "running <id> waited <ms> ms", the report lines of the job prefixed with "report " and finally
+* "done <id> ok|failed <ms> ms" follow. "status" is answered with the queued, running and finished jobs.
+*
+* Connections are accepted and their requests read on a thread of their own, which polls all of them together, so a
+* slow client does not delay the others. The jobs are taken by the threads calling next, every one with a
+* Generator attached to it. SIGTERM and SIGINT stop accepting, the jobs already queued are still run
+* (graceful drain) before next returns false. Windows supports the sockets since Windows 10 version 1803.
+**/
+class JobServer {
+public:
+    /// A queued job.
+    struct Job {
+        unsigned long long id = 0;
+        /// The input path and the parameters like on the command line.
+        std::vector<std::string> args;
+        /// The client connection, a socket of the platform.
+        std::intptr_t connection = -1;
+        /// Runs since the job was queued.
+        Timer queued;
+    };
+
+    /**
+    * \param const std::string& socketPath The path of the socket file, an existing one is replaced
+    * \param std::size_t capacity The most jobs waiting at the same time
+    **/
+    JobServer(const std::string& socketPath, std::size_t capacity);
+    /// Stops accepting and closes the socket.
+    ~JobServer();
+
+    JobServer(const JobServer&) = delete;
+    JobServer& operator=(const JobServer&) = delete;
+
+    /**
+    * Binds the socket, starts accepting and installs the signal handlers.
+    *
+    * \return false with an error printed if the socket can not be created
+    **/
+    bool start();
+    /**
+    * Waits for the next job.
+    *
+    * \param Job& job Receives the job, it has to be passed to finish
+    * \return false once a stop was requested and the queue is drained
+    **/
+    bool next(Job& job);
+    /// Sends a line to the client of a job. A client which went away is ignored.
+    void reply(const Job& job, const std::string& line) const;
+    /**
+    * Sends the report and the result of a job and closes its connection.
+    *
+    * \param Job& job The job from next
+    * \param bool ok Whether the job succeeded
+    * \param double ms The run time of the job
+    * \param const Report& report The report of the job
+    **/
+    void finish(Job& job, bool ok, double ms, const Report& report);
+    /// Whether SIGTERM or SIGINT was received.
+    static bool isStopRequested();
+    /**
+    * Splits a request line into arguments.
+    *
+    * \param const std::string& line The line without the line break
+    **/
+    static std::vector<std::string> split(const std::string& line);
+
+private:
+    /// See the constructor.
+    std::string socketPath;
+    std::size_t capacity;
+    /// The listening socket.
+    std::intptr_t listener = -1;
+    /// Runs acceptLoop.
+    std::thread acceptThread;
+    /// Guards everything below.
+    std::mutex mutex;
+    /// Signalled when a job is queued.
+    std::condition_variable available;
+    std::deque<Job> queue;
+    unsigned long long nextId = 1;
+    /// The ids of the running jobs.
+    std::vector<unsigned long long> running;
+    unsigned long long finished = 0;
+
+    /// Accepts connections until a stop is requested.
+    void acceptLoop();
+    /**
+    * Queues or answers a request.
+    *
+    * \param std::intptr_t connection The client connection
+    * \param const std::string& line The request line without the line break
+    **/
+    void handle(std::intptr_t connection, const std::string& line);
+};
+
+#endif // JOBSERVER_H
@@ -0,0 +1,54 @@
+// Include own header
+#include "./memoryStats.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cstdio>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+std::size_t memoryStats::currentRss() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#else
+    std::FILE* file = std::fopen("/proc/self/statm", "r");
+    if (file == nullptr) {
+        return 0;
+    }
+    long pages = 0;
+    long resident = 0;
+    if (std::fscanf(file, "%ld %ld", &pages, &resident) != 2) {
+        resident = 0;
+    }
+    std::fclose(file);
+    return (std::size_t)resident * (std::size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+std::size_t memoryStats::peakRss() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return (std::size_t)usage.ru_maxrss;
+#else
+    // Linux reports kilobytes
+    return (std::size_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
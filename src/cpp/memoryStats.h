@@ -0,0 +1,17 @@
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+// Include standard libraries
+#include <cstddef>
+
+/**
+* Queries of the process memory usage. Both return 0 if the platform does not provide the information.
+**/
+namespace memoryStats {
+    /// The resident set size (working set on Windows) of the process in bytes.
+    std::size_t currentRss();
+    /// The highest resident set size the process had so far in bytes.
+    std::size_t peakRss();
+}
+
+#endif // MEMORYSTATS_H
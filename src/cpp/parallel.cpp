@@ -0,0 +1,44 @@
+// Include own header
+#include "./parallel.h"
+#include "./arena.h"
+// Include standard libraries
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+    /// See setThreadCount, 0 if not limited.
+    thread_local unsigned int threadLimit = 0;
+}
+
+unsigned int parallel::threadCount() {
+    return threadLimit != 0 ? threadLimit : std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void parallel::setThreadCount(unsigned int count) {
+    threadLimit = count;
+}
+
+void parallel::forEach(unsigned int count, const std::function<void(unsigned int)>& task) {
+    std::atomic<unsigned int> next(0);
+    auto worker = [&]() {
+        for (unsigned int i = next++; i < count; i = next++) {
+            task(i);
+        }
+    };
+    const unsigned int threads = std::min(threadCount(), count);
+    std::vector<std::thread> helpers;
+    for (unsigned int t = 1; t < threads; ++t) {
+        // The helpers end with the call, their scratch arenas are lent so the chunks outlive them
+        helpers.emplace_back([&]() {
+            const ScratchLease lease;
+            worker();
+        });
+    }
+    // The calling thread works as well
+    worker();
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+}
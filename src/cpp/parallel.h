@@ -0,0 +1,31 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+// Include standard libraries
+#include <functional>
+
+/**
+* Minimal helpers to spread independent work items over all cores.
+**/
+namespace parallel {
+    /// The number of worker threads used by the calling thread, one per hardware thread unless setThreadCount was called.
+    unsigned int threadCount();
+    /**
+    * Limits the threads of forEach and of new TaskSchedulers called from the calling thread, so generators running
+    * side by side share the cores instead of each starting a thread per core.
+    *
+    * \param unsigned int count The number of threads, 0 uses all hardware threads again
+    **/
+    void setThreadCount(unsigned int count);
+    /**
+    * Calls task(i) for every i in [0, count) and returns when all calls are done.
+    * Items are handed out one by one, so items with different costs balance out. The helper threads only live for
+    * the call, their Arena::scratch is lent from a pool, see ScratchLease.
+    *
+    * \param unsigned int count The number of work items
+    * \param const std::function<void(unsigned int)>& task The work for one item
+    **/
+    void forEach(unsigned int count, const std::function<void(unsigned int)>& task);
+}
+
+#endif // PARALLEL_H
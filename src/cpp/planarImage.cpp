@@ -0,0 +1,100 @@
+// Include own header
+#include "./planarImage.h"
+#include "./arena.h"
+// Include standard libraries
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+    /// The alignment of rows and allocations in floats.
+    const std::size_t alignment = 16;
+
+    void release(float* data) {
+#ifdef _WIN32
+        _aligned_free(data);
+#else
+        std::free(data);
+#endif
+    }
+}
+
+PlanarImage::PlanarImage(unsigned int width, unsigned int height, Arena* arena)
+    : width(width), height(height), stride(rowStride(width)) {
+    const std::size_t count = this->stride * height * 3;
+    this->data = arena != nullptr ? arena->allocateFloats(count) : allocate(count);
+}
+
+std::size_t PlanarImage::rowStride(unsigned int width) {
+    return (std::size_t(width) + alignment - 1) / alignment * alignment;
+}
+
+std::size_t PlanarImage::bytesFor(unsigned int width, unsigned int height) {
+    return rowStride(width) * height * 3 * sizeof(float);
+}
+
+PlanarImage::Buffer PlanarImage::allocate(std::size_t count) {
+    const std::size_t bytes = std::max(count, std::size_t(1)) * sizeof(float);
+#ifdef _WIN32
+    float* data = (float*)_aligned_malloc(bytes, alignment * sizeof(float));
+#else
+    void* memory = nullptr;
+    float* data = posix_memalign(&memory, alignment * sizeof(float), bytes) == 0 ? (float*)memory : nullptr;
+#endif
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+    std::fill(data, data + count, 0.0f);
+    return Buffer(data, release);
+}
+
+void PlanarImage::deinterleave(const float* rgb, const ImageView& view) {
+    for (unsigned int y = 0; y < view.height; ++y) {
+        const float* src = rgb + std::size_t(y) * view.width * 3;
+        float* r = view.row(0, y);
+        float* g = view.row(1, y);
+        float* b = view.row(2, y);
+        for (unsigned int x = 0; x < view.width; ++x) {
+            r[x] = src[x * 3 + 0];
+            g[x] = src[x * 3 + 1];
+            b[x] = src[x * 3 + 2];
+        }
+    }
+}
+
+void PlanarImage::interleave(const ConstImageView& view, float* rgb) {
+    for (unsigned int y = 0; y < view.height; ++y) {
+        float* dst = rgb + std::size_t(y) * view.width * 3;
+        const float* r = view.row(0, y);
+        const float* g = view.row(1, y);
+        const float* b = view.row(2, y);
+        for (unsigned int x = 0; x < view.width; ++x) {
+            dst[x * 3 + 0] = r[x];
+            dst[x * 3 + 1] = g[x];
+            dst[x * 3 + 2] = b[x];
+        }
+    }
+}
+
+unsigned int PlanarImage::getWidth() const {
+    return this->width;
+}
+
+unsigned int PlanarImage::getHeight() const {
+    return this->height;
+}
+
+std::size_t PlanarImage::getBytes() const {
+    return bytesFor(this->width, this->height);
+}
+
+ImageView PlanarImage::getView() {
+    return ImageView(this->data.get(), this->width, this->height, this->stride, this->stride * this->height);
+}
+
+ConstImageView PlanarImage::getView() const {
+    return ConstImageView(this->data.get(), this->width, this->height, this->stride, this->stride * this->height);
+}
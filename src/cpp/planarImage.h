@@ -0,0 +1,111 @@
+#ifndef PLANARIMAGE_H
+#define PLANARIMAGE_H
+
+// Include standard libraries
+#include <cstddef>
+#include <memory>
+
+class Arena;
+
+/**
+* A view of an RGB float image stored as three separate planes. Every row starts on a 64 byte boundary: the row
+* stride is a multiple of 16 floats, the plane stride a multiple of the row stride. The view does not own the
+* memory, see PlanarImage and CubeImage for the owners.
+**/
+template <typename T>
+struct PlanarView {
+    /// The first row of the red plane.
+    T* data = nullptr;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    /// Floats from one row to the next.
+    std::size_t stride = 0;
+    /// Floats from one plane to the next.
+    std::size_t planeStride = 0;
+
+    PlanarView() {}
+    PlanarView(T* data, unsigned int width, unsigned int height, std::size_t stride, std::size_t planeStride)
+        : data(data), width(width), height(height), stride(stride), planeStride(planeStride) {}
+    /// A read only view of a writable one.
+    template <typename U>
+    PlanarView(const PlanarView<U>& other)
+        : data(other.data), width(other.width), height(other.height), stride(other.stride), planeStride(other.planeStride) {}
+
+    /// The first value of a row of a channel, 64 byte aligned.
+    T* row(unsigned int channel, unsigned int y) const {
+        return this->data + channel * this->planeStride + y * this->stride;
+    }
+    /// A value of a channel.
+    T& at(unsigned int channel, unsigned int x, unsigned int y) const {
+        return this->row(channel, y)[x];
+    }
+};
+
+typedef PlanarView<float> ImageView;
+typedef PlanarView<const float> ConstImageView;
+
+/**
+* \class PlanarImage
+*
+* \brief An RGB float image with planar storage, see PlanarView for the layout.
+*
+* The CPU kernels work on planes, so SIMD loads of a row are aligned and contiguous per channel. Interleaved RGB
+* only exists at the IO boundary, where interleave and deinterleave convert rows.
+**/
+class PlanarImage {
+public:
+    /// 64 byte aligned floats which are released with the matching function.
+    typedef std::unique_ptr<float[], void(*)(float*)> Buffer;
+
+    /// Creates an empty image.
+    PlanarImage() {}
+    /**
+    * Creates an image with zeroed content.
+    *
+    * \param unsigned int width The width in texels
+    * \param unsigned int height The height in texels
+    * \param Arena* arena Takes the planes from the arena instead of the heap if set
+    **/
+    PlanarImage(unsigned int width, unsigned int height, Arena* arena = nullptr);
+
+    /// The stride in floats of a row of the given width, rounded up to 64 bytes.
+    static std::size_t rowStride(unsigned int width);
+    /// The memory in bytes of an image of the given size.
+    static std::size_t bytesFor(unsigned int width, unsigned int height);
+    /**
+    * Allocates 64 byte aligned floats, set to 0.
+    *
+    * \param std::size_t count The number of floats
+    **/
+    static Buffer allocate(std::size_t count);
+
+    /**
+    * Copies interleaved RGB rows into the planes of a view.
+    *
+    * \param const float* rgb view.height rows of view.width RGB texels
+    * \param const ImageView& view The destination
+    **/
+    static void deinterleave(const float* rgb, const ImageView& view);
+    /**
+    * Copies the planes of a view into interleaved RGB rows.
+    *
+    * \param const ConstImageView& view The source
+    * \param float* rgb Receives view.height rows of view.width RGB texels
+    **/
+    static void interleave(const ConstImageView& view, float* rgb);
+
+    unsigned int getWidth() const;
+    unsigned int getHeight() const;
+    /// The memory of the planes in bytes.
+    std::size_t getBytes() const;
+    ImageView getView();
+    ConstImageView getView() const;
+
+private:
+    unsigned int width = 0;
+    unsigned int height = 0;
+    std::size_t stride = 0;
+    Buffer data { nullptr, nullptr };
+};
+
+#endif // PLANARIMAGE_H
@@ -0,0 +1,284 @@
+// Include own header
+#include "./probeBatch.h"
+#include "./cubeImage.h"
+#include "./fileSystem.h"
+#include "./hdrio.h"
+// Include standard libraries
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+namespace {
+    /// What a batch may take in main and texture memory together when setBatchSize(-1) picks the size.
+    const std::size_t batchBudgetBytes = std::size_t(256) << 20;
+
+    /// A product level of a batch as read back: the buffer and the side width of its faces.
+    typedef std::pair<const float*, unsigned int> Segment;
+
+    /**
+    * Writes the row block of one probe, top row first. Every segment is six faces wide, smaller segments are
+    * top aligned and filled with black below.
+    **/
+    void writeProbeRows(HdrWriter& writer, const std::vector<Segment>& segments, unsigned int probe, unsigned int rows, float* scanline) {
+        for (unsigned int y = 0; y < rows; ++y) {
+            float* pixel = scanline;
+            for (const Segment& segment : segments) {
+                const unsigned int size = segment.second;
+                const std::size_t rowFloats = std::size_t(size) * 3;
+                for (unsigned int face = 0; face < 6; ++face) {
+                    if (y < size) {
+                        // The products have the bottom row first
+                        const float* row = segment.first + ((std::size_t(probe) * 6 + face) * size + (size - 1 - y)) * rowFloats;
+                        std::copy(row, row + rowFloats, pixel);
+                    }
+                    else {
+                        std::fill(pixel, pixel + rowFloats, 0.0f);
+                    }
+                    pixel += rowFloats;
+                }
+            }
+            writer.writeScanline(scanline);
+        }
+    }
+}
+
+ProbeBatch::ProbeBatch(const std::vector<std::string>& inputs, Backend& backend, Report& report, Arena& arena)
+    : inputs(inputs), backend(backend), report(report), arena(arena) {
+    if (inputs.empty()) {
+        std::cout << "ERROR: No probes provided" << std::endl;
+        throw(1);
+    }
+    for (const std::string& input : inputs) {
+        // Only the header is read here, the pixels are decoded per batch
+        HdrReader reader(input);
+        if (this->width == 0) {
+            this->width = reader.getWidth();
+            this->height = reader.getHeight();
+        }
+        if (reader.getWidth() == 0 || reader.getHeight() == 0 || reader.getWidth() != this->width || reader.getHeight() != this->height) {
+            std::cout << "ERROR: Probe size differs from the first probe: " << input << std::endl;
+            throw(2);
+        }
+    }
+}
+
+void ProbeBatch::setFaceSize(unsigned int size) {
+    this->faceSize = size;
+}
+
+unsigned int ProbeBatch::getFaceSize() const {
+    return this->faceSize != 0 ? this->faceSize : std::max(this->width / 4, 1u);
+}
+
+void ProbeBatch::setIrradianceSize(unsigned int size) {
+    this->irradianceSize = std::max(size, 1u);
+}
+
+void ProbeBatch::setMipLevels(unsigned int levels) {
+    this->mipLevels = std::max(levels, 1u);
+}
+
+void ProbeBatch::setBatchSize(int probes) {
+    this->batchSize = probes;
+}
+
+unsigned int ProbeBatch::levelSize(unsigned int level) const {
+    return std::max(this->getFaceSize() >> level, 1u);
+}
+
+unsigned int ProbeBatch::levelCount() const {
+    return std::min(this->mipLevels, CubeImage::fullLevelCount(this->getFaceSize()));
+}
+
+unsigned int ProbeBatch::chooseBatchSize() const {
+    const std::size_t faceTexels = std::size_t(this->getFaceSize()) * this->getFaceSize();
+    const unsigned int irradianceSize = std::min(this->irradianceSize, this->getFaceSize());
+    const std::size_t sourceTexels = std::size_t(this->width) * this->height;
+    std::size_t levelTexels = 0;
+    for (unsigned int level = 0; level < this->levelCount(); ++level) {
+        levelTexels += std::size_t(this->levelSize(level)) * this->levelSize(level);
+    }
+    // RGB16F textures with their mip chains on the device, float RGB sources and read back levels on the host
+    const std::size_t deviceBytes = (sourceTexels * 4 / 3 + 6 * faceTexels * 4 / 3 * 2 + 6 * std::size_t(irradianceSize) * irradianceSize) * 6;
+    const std::size_t hostBytes = (sourceTexels + 6 * faceTexels + 6 * std::size_t(irradianceSize) * irradianceSize + 6 * levelTexels) * 3 * sizeof(float);
+    return (unsigned int)std::max(batchBudgetBytes / (deviceBytes + hostBytes), std::size_t(1));
+}
+
+const float* ProbeBatch::loadSource(const std::string& path) const {
+    HdrReader reader(path);
+    // The file starts with the top row, the backends take the bottom row first
+    const std::size_t rowFloats = std::size_t(this->width) * 3;
+    float* rgb = (float*)this->arena.allocate(rowFloats * this->height * sizeof(float));
+    for (unsigned int y = this->height; y-- > 0;) {
+        if (!reader.readScanline(rgb + y * rowFloats)) {
+            std::cout << "ERROR: Could not read probe: " << path << std::endl;
+            throw(2);
+        }
+    }
+    return rgb;
+}
+
+void ProbeBatch::run(const std::string& out, const std::string& name) {
+    fileSystem::makeDirectories(out);
+
+    Timer total;
+    const unsigned int probes = (unsigned int)this->inputs.size();
+    const unsigned int faceSize = this->getFaceSize();
+    const unsigned int irradianceSize = std::min(this->irradianceSize, faceSize);
+    const unsigned int levels = this->levelCount();
+    unsigned int levelWidths = 0;
+    for (unsigned int level = 0; level < levels; ++level) {
+        levelWidths += this->levelSize(level);
+    }
+
+    const unsigned int maxBatch = this->backend.getMaxProbeBatch();
+    const bool batched = this->batchSize != 0 && maxBatch > 0;
+    unsigned int perBatch = this->batchSize > 0 ? (unsigned int)this->batchSize : this->chooseBatchSize();
+    if (batched) {
+        perBatch = std::min(perBatch, maxBatch);
+    }
+    perBatch = std::max(std::min(perBatch, probes), 1u);
+
+    std::ofstream index(out + "/probes_" + name + ".txt", std::ios::trunc);
+    index << "# " << probes << " probes, face size " << faceSize << ", irradiance size " << irradianceSize << ", prefiltered level sizes";
+    for (unsigned int level = 0; level < levels; ++level) {
+        index << " " << this->levelSize(level);
+    }
+    index << std::endl;
+    index << "# Probe i covers the rows i * size to (i + 1) * size - 1 from the top, faces +X -X +Y -Y +Z -Z side by side" << std::endl;
+    for (unsigned int probe = 0; probe < probes; ++probe) {
+        index << probe << " " << this->inputs[probe] << std::endl;
+    }
+    index.close();
+
+    HdrWriter background(out + "/background_" + name + ".hdr", 6 * faceSize, probes * faceSize);
+    HdrWriter irradiance(out + "/irradiance_" + name + ".hdr", 6 * irradianceSize, probes * irradianceSize);
+    HdrWriter environment(out + "/environment_" + name + ".hdr", 6 * levelWidths, probes * faceSize);
+
+    double loadMs = 0.0;
+    double renderMs = 0.0;
+    double readBackMs = 0.0;
+    double writeMs = 0.0;
+    unsigned int batches = 0;
+    for (unsigned int first = 0; first < probes; first += perBatch) {
+        const ArenaScope scope(this->arena);
+        const unsigned int count = std::min(perBatch, probes - first);
+
+        Timer timer;
+        std::vector<const float*> sources;
+        for (unsigned int probe = first; probe < first + count; ++probe) {
+            sources.push_back(this->loadSource(this->inputs[probe]));
+        }
+        loadMs += timer.elapsedMs();
+
+        // Background, irradiance and the prefiltered levels of all probes of the batch
+        std::vector<unsigned int> sizes(1, faceSize);
+        sizes.push_back(irradianceSize);
+        for (unsigned int level = 0; level < levels; ++level) {
+            sizes.push_back(this->levelSize(level));
+        }
+        std::vector<float*> products;
+        for (unsigned int size : sizes) {
+            products.push_back((float*)this->arena.allocate(std::size_t(count) * 6 * size * size * 3 * sizeof(float)));
+        }
+
+        if (batched) {
+            timer.restart();
+            this->backend.makeProbeBatch(sources, this->width, this->height, faceSize, irradianceSize, this->mipLevels);
+            this->backend.finish();
+            renderMs += timer.elapsedMs();
+            timer.restart();
+            bool ok = this->backend.readBackProbeLevel(Product::Background, 0, products[0])
+                && this->backend.readBackProbeLevel(Product::Irradiance, 0, products[1]);
+            for (unsigned int level = 0; level < levels; ++level) {
+                ok = ok && this->backend.readBackProbeLevel(Product::Prefiltered, level, products[2 + level]);
+            }
+            if (!ok) {
+                std::cout << "ERROR: Could not read back the probes from: " << this->inputs[first] << std::endl;
+                throw(4);
+            }
+            readBackMs += timer.elapsedMs();
+        }
+        else {
+            timer.restart();
+            double singleReadBackMs = 0.0;
+            this->runSingleProbes(sources, products, singleReadBackMs);
+            renderMs += timer.elapsedMs() - singleReadBackMs;
+            readBackMs += singleReadBackMs;
+        }
+
+        timer.restart();
+        float* scanline = (float*)this->arena.allocate(std::size_t(6) * std::max(faceSize, levelWidths) * 3 * sizeof(float));
+        std::vector<Segment> environmentSegments;
+        for (unsigned int level = 0; level < levels; ++level) {
+            environmentSegments.push_back(Segment(products[2 + level], this->levelSize(level)));
+        }
+        for (unsigned int probe = 0; probe < count; ++probe) {
+            writeProbeRows(background, std::vector<Segment>(1, Segment(products[0], faceSize)), probe, faceSize, scanline);
+            writeProbeRows(irradiance, std::vector<Segment>(1, Segment(products[1], irradianceSize)), probe, irradianceSize, scanline);
+            writeProbeRows(environment, environmentSegments, probe, faceSize, scanline);
+        }
+        writeMs += timer.elapsedMs();
+        batches++;
+    }
+    this->backend.releaseProbeBatch();
+    background.commit();
+    irradiance.commit();
+    environment.commit();
+
+    std::ostringstream value;
+    value << probes << " in " << batches << " batches of up to " << perBatch << (batched ? ", batched" : ", probe after probe");
+    this->report.addValue("probes", value.str());
+    this->report.addTiming("probe load", loadMs);
+    this->report.addTiming(this->backend.getName() + " probe render", renderMs);
+    this->report.addTiming(this->backend.getName() + " probe read back", readBackMs);
+    this->report.addTiming("probe write", writeMs);
+    value.str("");
+    value << std::fixed << std::setprecision(1) << probes * 1000.0 / std::max(total.elapsedMs(), 1e-3)
+        << " (render only " << probes * 1000.0 / std::max(renderMs, 1e-3) << ")";
+    this->report.addValue("probes per second", value.str());
+    this->backend.reportResources();
+}
+
+void ProbeBatch::runSingleProbes(const std::vector<const float*>& sources, std::vector<float*>& products, double& readBackMs) {
+    const unsigned int faceSize = this->getFaceSize();
+    const unsigned int irradianceSize = std::min(this->irradianceSize, faceSize);
+    // The stages report per call, a line per probe would bury the summary
+    const std::size_t entries = this->report.getEntryCount();
+    bool ok = true;
+    for (unsigned int probe = 0; probe < (unsigned int)sources.size(); ++probe) {
+        this->backend.uploadSource(sources[probe], this->width, this->height);
+        this->backend.makeBaseCube(faceSize);
+        this->backend.makeIrradiance(irradianceSize);
+        this->backend.finish();
+        Timer timer;
+        for (unsigned int face = 0; face < 6; ++face) {
+            ok = ok && this->backend.readBackLevel(Product::Background, face, 0, products[0] + (std::size_t(probe) * 6 + face) * faceSize * faceSize * 3);
+            ok = ok && this->backend.readBackLevel(Product::Irradiance, face, 0, products[1] + (std::size_t(probe) * 6 + face) * irradianceSize * irradianceSize * 3);
+        }
+        readBackMs += timer.elapsedMs();
+        this->backend.releaseProduct(Product::Irradiance);
+
+        this->backend.makePrefilteredChain(this->mipLevels, true);
+        this->backend.finish();
+        timer.restart();
+        for (unsigned int level = 0; level < this->levelCount(); ++level) {
+            const std::size_t size = this->levelSize(level);
+            for (unsigned int face = 0; face < 6; ++face) {
+                ok = ok && this->backend.readBackLevel(Product::Prefiltered, face, level, products[2 + level] + (std::size_t(probe) * 6 + face) * size * size * 3);
+            }
+        }
+        readBackMs += timer.elapsedMs();
+        this->backend.releaseProduct(Product::Prefiltered);
+        this->backend.releaseProduct(Product::Background);
+    }
+    this->report.truncate(entries);
+    if (!ok) {
+        std::cout << "ERROR: Could not read back a probe" << std::endl;
+        throw(4);
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef PROBEBATCH_H
+#define PROBEBATCH_H
+
+// Include standard libraries
+#include <cstddef>
+#include <string>
+#include <vector>
+// Include own classes
+#include "./arena.h"
+#include "./backend.h"
+#include "./report.h"
+
+/**
+* \class ProbeBatch
+*
+* \brief Converts many small light probes into three packed .hdr files instead of a job and 6 files per probe.
+*
+* Baked probe grids are thousands of small captures, where the overhead per job dominates: six draws per face set
+* and stage and a file per face. The probes are handed to Backend::makeProbeBatch in batches, the gl backend renders
+* a batch into cube map arrays with one instanced draw per stage and prefiltered level. Backends without a batch mode
+* run the usual stages probe after probe. All sources have to share one size.
+*
+* The packed files start with the top row. Every probe is a block of rows as high as its faces, the first probe at
+* the top. In a block the faces +X, -X, +Y, -Y, +Z, -Z are side by side. The prefiltered file puts the levels next
+* to each other, level 0 on the left, each top aligned with black below. probes_[name].txt lists the probes.
+**/
+class ProbeBatch {
+public:
+    /**
+    * \brief Reads the headers of all sources.
+    *
+    * Prints an error and throws if a source can not be read or has another size than the first.
+    *
+    * \param const std::vector<std::string>& inputs The equirectangular .hdr sources, one per probe
+    * \param Backend& backend The backend doing the image processing, its knobs are used as set
+    * \param Report& report Receives the measurements
+    * \param Arena& arena Supplies the sources and the read back products of a batch
+    **/
+    ProbeBatch(const std::vector<std::string>& inputs, Backend& backend, Report& report, Arena& arena);
+
+    /// The side width of the background and prefiltered cubes. 0 uses a quarter of the source width.
+    void setFaceSize(unsigned int size);
+    /// The side width of the background and prefiltered cubes.
+    unsigned int getFaceSize() const;
+    /// The side width of the irradiance cubes, at most the face size.
+    void setIrradianceSize(unsigned int size);
+    /// The number of prefiltered levels, see Backend::makePrefilteredChain.
+    void setMipLevels(unsigned int levels);
+    /**
+    * The number of probes per batch.
+    *
+    * \param int probes -1 takes as many as fit into the memory budget of a batch and the backend allows. 0 runs
+    * the usual stages probe after probe, e.g. to compare the throughput.
+    **/
+    void setBatchSize(int probes);
+
+    /**
+    * Runs all batches and writes the packed files [out]/background_[name].hdr, irradiance_[name].hdr and
+    * environment_[name].hdr.
+    *
+    * \param const std::string& out The output directory, it is created if needed
+    * \param const std::string& name The name of the files
+    **/
+    void run(const std::string& out, const std::string& name);
+
+private:
+    /// See the constructor.
+    std::vector<std::string> inputs;
+    Backend& backend;
+    Report& report;
+    Arena& arena;
+    /// The size of every source.
+    unsigned int width = 0;
+    unsigned int height = 0;
+    /// See the setters.
+    unsigned int faceSize = 0;
+    unsigned int irradianceSize = 64;
+    unsigned int mipLevels = 6;
+    int batchSize = -1;
+
+    /// The side width of a prefiltered level.
+    unsigned int levelSize(unsigned int level) const;
+    /// The number of prefiltered levels which exist at the face size.
+    unsigned int levelCount() const;
+    /// The probes of a batch for setBatchSize(-1).
+    unsigned int chooseBatchSize() const;
+    /// Decodes a source with the bottom row first, the memory is taken from the arena.
+    const float* loadSource(const std::string& path) const;
+    /**
+    * Renders a batch probe after probe with the usual stages and reads the products back like readBackProbeLevel.
+    *
+    * \param const std::vector<const float*>& sources The sources of the batch
+    * \param std::vector<float*>& products Background, irradiance and one buffer per prefiltered level
+    * \param double& readBackMs Receives the time of the read backs in addition
+    **/
+    void runSingleProbes(const std::vector<const float*>& sources, std::vector<float*>& products, double& readBackMs);
+};
+
+#endif // PROBEBATCH_H
@@ -0,0 +1,214 @@
+// Include own header
+#include "./programCache.h"
+#include "./fileSystem.h"
+#include "./shaderSources.h"
+// Include standard libraries
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace {
+    /// The first bytes of every cache file.
+    const char magic[8] = { 'C', 'M', 'G', 'P', 'R', 'O', 'G', '1' };
+
+    /// FNV-1a, enough to tell sources apart. The driver string is checked separately.
+    std::uint64_t hash(const std::string& text, std::uint64_t value = 14695981039346656037ull) {
+        for (unsigned char c : text) {
+            value = (value ^ c) * 1099511628211ull;
+        }
+        return value;
+    }
+
+    std::string getString(GLenum name) {
+        const GLubyte* value = glGetString(name);
+        return value != nullptr ? std::string((const char*)value) : std::string();
+    }
+
+    /// The source with the defines inserted after its #version line, which has to stay the first statement.
+    std::string specialize(const std::string& code, const std::string& defines) {
+        if (defines.empty() || code.empty()) {
+            return code;
+        }
+        const std::size_t version = code.find("#version");
+        const std::size_t lineEnd = version == std::string::npos ? std::string::npos : code.find('\n', version);
+        if (lineEnd == std::string::npos) {
+            return defines + code;
+        }
+        return code.substr(0, lineEnd + 1) + defines + code.substr(lineEnd + 1);
+    }
+
+    /// Prints the log of a failed compile or link like the Shader class does.
+    bool checkStatus(GLuint object, bool program) {
+        GLint success = 0;
+        GLchar infoLog[1024];
+        if (program) {
+            glGetProgramiv(object, GL_LINK_STATUS, &success);
+            if (!success) {
+                glGetProgramInfoLog(object, 1024, NULL, infoLog);
+                std::cout << "ERROR::PROGRAM_LINKING_ERROR\n" << infoLog << std::endl;
+            }
+        }
+        else {
+            glGetShaderiv(object, GL_COMPILE_STATUS, &success);
+            if (!success) {
+                glGetShaderInfoLog(object, 1024, NULL, infoLog);
+                std::cout << "ERROR::SHADER_COMPILATION_ERROR\n" << infoLog << std::endl;
+            }
+        }
+        return success != 0;
+    }
+}
+
+ProgramCache::ProgramCache(const std::string& directory) : directory(directory) {
+    this->driver = getString(GL_VENDOR) + "|" + getString(GL_RENDERER) + "|" + getString(GL_VERSION);
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    this->supported = formats > 0;
+    if (this->supported) {
+        fileSystem::makeDirectories(directory);
+    }
+}
+
+ShaderProgram ProgramCache::load(const std::string& vertexName, const std::string& fragmentName, const std::string& defines, const std::string& geometryName) {
+    Timer timer;
+    const std::string vertexCode = shaderSources::get(vertexName);
+    const std::string fragmentCode = specialize(shaderSources::get(fragmentName), defines);
+    const std::string geometryCode = geometryName.empty() ? std::string() : shaderSources::get(geometryName);
+    if (vertexCode.empty() || fragmentCode.empty() || (!geometryName.empty() && geometryCode.empty())) {
+        std::cout << "ERROR: Unknown shader: " << vertexName << " : " << fragmentName << (geometryName.empty() ? "" : " : " + geometryName) << std::endl;
+        return ShaderProgram();
+    }
+
+    std::ostringstream fileName;
+    fileName << this->directory << "/" << std::hex << std::setw(16) << std::setfill('0')
+        << hash(geometryCode, hash(fragmentCode, hash(vertexCode, hash(this->driver)))) << ".bin";
+    GLHandle program;
+    if (this->supported) {
+        program = this->loadBinary(fileName.str());
+    }
+    if (program.get() != 0) {
+        this->loaded++;
+    }
+    else {
+        program = this->compile(vertexCode, fragmentCode, geometryCode);
+        this->compiled++;
+        if (this->supported) {
+            this->saveBinary(program.get(), fileName.str());
+        }
+    }
+    ShaderProgram shader(std::move(program));
+    this->ms += timer.elapsedMs();
+    return shader;
+}
+
+GLHandle ProgramCache::loadBinary(const std::string& fileName) const {
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file) {
+        return GLHandle();
+    }
+    char header[sizeof(magic)];
+    std::uint32_t driverLength = 0;
+    if (!file.read(header, sizeof(header)) || !std::equal(magic, magic + sizeof(magic), header)
+        || !file.read((char*)&driverLength, sizeof(driverLength)) || driverLength != this->driver.size()) {
+        return GLHandle();
+    }
+    std::string driver(driverLength, '\0');
+    std::uint32_t format = 0;
+    std::uint32_t length = 0;
+    if (!file.read(&driver[0], driverLength) || driver != this->driver
+        || !file.read((char*)&format, sizeof(format)) || !file.read((char*)&length, sizeof(length))) {
+        return GLHandle();
+    }
+    std::vector<char> binary(length);
+    if (!file.read(binary.data(), length)) {
+        return GLHandle();
+    }
+    GLHandle program(GLHandle::Kind::Program);
+    glProgramBinary(program.get(), format, binary.data(), length);
+    GLint success = 0;
+    glGetProgramiv(program.get(), GL_LINK_STATUS, &success);
+    if (!success) {
+        // Rejected by the driver, e.g. after an update which kept the version string
+        return GLHandle();
+    }
+    return program;
+}
+
+void ProgramCache::saveBinary(GLuint program, const std::string& fileName) const {
+    GLint linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        return;
+    }
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, NULL, &format, binary.data());
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    const std::uint32_t driverLength = (std::uint32_t)this->driver.size();
+    const std::uint32_t binaryFormat = format;
+    const std::uint32_t binaryLength = (std::uint32_t)length;
+    file.write(magic, sizeof(magic));
+    file.write((const char*)&driverLength, sizeof(driverLength));
+    file.write(this->driver.data(), driverLength);
+    file.write((const char*)&binaryFormat, sizeof(binaryFormat));
+    file.write((const char*)&binaryLength, sizeof(binaryLength));
+    file.write(binary.data(), length);
+    // A partly written file fails the length check of the next load and is written again
+}
+
+GLHandle ProgramCache::compile(const std::string& vertexCode, const std::string& fragmentCode, const std::string& geometryCode) const {
+    const char* vShaderCode = vertexCode.c_str();
+    const char* fShaderCode = fragmentCode.c_str();
+    const GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, &vShaderCode, NULL);
+    glCompileShader(vertex);
+    checkStatus(vertex, false);
+    const GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment, 1, &fShaderCode, NULL);
+    glCompileShader(fragment);
+    checkStatus(fragment, false);
+    GLuint geometry = 0;
+    if (!geometryCode.empty()) {
+        const char* gShaderCode = geometryCode.c_str();
+        geometry = glCreateShader(GL_GEOMETRY_SHADER);
+        glShaderSource(geometry, 1, &gShaderCode, NULL);
+        glCompileShader(geometry);
+        checkStatus(geometry, false);
+    }
+    GLHandle program(GLHandle::Kind::Program);
+    // Has to be set before linking, some drivers return no binary otherwise
+    glProgramParameteri(program.get(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader(program.get(), vertex);
+    glAttachShader(program.get(), fragment);
+    if (geometry != 0) {
+        glAttachShader(program.get(), geometry);
+    }
+    glLinkProgram(program.get());
+    checkStatus(program.get(), true);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    if (geometry != 0) {
+        glDeleteShader(geometry);
+    }
+    return program;
+}
+
+void ProgramCache::addTo(Report& report, const std::string& name) const {
+    std::ostringstream value;
+    value << (this->compiled == 0 ? "warm start, " : "cold start, ") << this->loaded << " from cache, " << this->compiled << " compiled";
+    if (!this->supported) {
+        value << " (no binary formats)";
+    }
+    value << ", " << std::fixed << std::setprecision(1) << this->ms << " ms";
+    report.addValue(name, value.str());
+}
@@ -0,0 +1,74 @@
+#ifndef PROGRAMCACHE_H
+#define PROGRAMCACHE_H
+
+// Include standard libraries
+#include <cstdint>
+#include <string>
+// Include glad for OpenGL function pointers
+#include "glad/glad.h"
+// Include own classes
+#include "./glResources.h"
+#include "./report.h"
+#include "./shaderProgram.h"
+
+/**
+* \class ProgramCache
+*
+* \brief Loads shader programs from driver binaries saved by a previous run instead of compiling them.
+*
+* A binary is stored per program in the cache directory under a hash of the driver (vendor, renderer, version)
+* and of the shader sources, so a driver update or an edited shader never picks up a stale binary. Binaries the
+* driver rejects are replaced by compiling the sources again. Drivers without binary formats always compile.
+* The context the programs are used in has to be current.
+**/
+class ProgramCache {
+public:
+    /**
+    * \param const std::string& directory Where the binaries are stored, it is created if needed
+    **/
+    explicit ProgramCache(const std::string& directory);
+
+    /**
+    * A linked program from the cache or compiled from its sources, see shaderSources.
+    *
+    * \param const std::string& vertexName The name of the vertex shader
+    * \param const std::string& fragmentName The name of the fragment shader
+    * \param const std::string& defines Lines inserted after the #version line of the fragment shader to build a
+    * specialized variant, e.g. "#define SAMPLE_COUNT 1024u\n". Every variant is cached on its own.
+    * \param const std::string& geometryName The name of a geometry shader linked in between, empty for none
+    * \return The program, it is empty if there is no such shader
+    **/
+    ShaderProgram load(const std::string& vertexName, const std::string& fragmentName, const std::string& defines = "", const std::string& geometryName = "");
+
+    /**
+    * Adds the number of loaded and compiled programs and the time spent to the report. A start without any
+    * compile is a warm start.
+    *
+    * \param Report& report The report
+    * \param const std::string& name The name of the entry
+    **/
+    void addTo(Report& report, const std::string& name) const;
+
+private:
+    /// See the constructor.
+    std::string directory;
+    /// Vendor, renderer and version of the driver.
+    std::string driver;
+    /// Whether the driver supports at least one binary format.
+    bool supported = false;
+    /// Programs loaded from a binary.
+    unsigned int loaded = 0;
+    /// Programs compiled from their sources.
+    unsigned int compiled = 0;
+    /// The time spent in load.
+    double ms = 0.0;
+
+    /// The program of a cache file, empty if there is no usable one.
+    GLHandle loadBinary(const std::string& fileName) const;
+    /// Stores the binary of a linked program.
+    void saveBinary(GLuint program, const std::string& fileName) const;
+    /// Compiles and links a program with a retrievable binary. The geometry shader is left out if its code is empty.
+    GLHandle compile(const std::string& vertexCode, const std::string& fragmentCode, const std::string& geometryCode) const;
+};
+
+#endif // PROGRAMCACHE_H
@@ -0,0 +1,47 @@
+// Include own header
+#include "./report.h"
+// Include standard libraries
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+void Report::addTiming(const std::string& stage, double ms) {
+    std::ostringstream value;
+    value << std::fixed << std::setprecision(1) << ms << " ms";
+    this->entries.push_back(std::make_pair(stage, value.str()));
+}
+
+void Report::addValue(const std::string& key, const std::string& value) {
+    this->entries.push_back(std::make_pair(key, value));
+}
+
+void Report::clear() {
+    this->entries.clear();
+}
+
+std::size_t Report::getEntryCount() const {
+    return this->entries.size();
+}
+
+void Report::truncate(std::size_t count) {
+    if (count < this->entries.size()) {
+        this->entries.resize(count);
+    }
+}
+
+void Report::print(std::ostream& output) const {
+    std::size_t keyWidth = 0;
+    for (const auto& entry : this->entries) {
+        keyWidth = std::max(keyWidth, entry.first.size());
+    }
+    output << "---- Summary ----" << std::endl;
+    for (const auto& entry : this->entries) {
+        output << std::left << std::setw(keyWidth + 2) << entry.first + ":" << entry.second << std::endl;
+    }
+}
+
+std::string Report::formatBytes(std::size_t bytes) {
+    std::ostringstream value;
+    value << std::fixed << std::setprecision(1) << bytes / (1024.0 * 1024.0) << " MB";
+    return value.str();
+}
@@ -0,0 +1,67 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+// Include standard libraries
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+* A simple wall clock stopwatch. It starts running on construction.
+**/
+class Timer {
+public:
+    Timer() : begin(std::chrono::steady_clock::now()) {}
+    /// Restarts the measurement.
+    void restart() { this->begin = std::chrono::steady_clock::now(); }
+    /// Milliseconds since construction or the last restart.
+    double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - this->begin).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point begin;
+};
+
+/**
+* \class Report
+*
+* Collects timings and other measurements of a run and prints them as a summary at the end.
+* Entries are printed in the order they were added.
+**/
+class Report {
+public:
+    /**
+    * Adds a timing entry.
+    *
+    * \param std::string& stage The name of the measured stage
+    * \param double ms The measured time in milliseconds
+    **/
+    void addTiming(const std::string& stage, double ms);
+    /**
+    * Adds an arbitrary measurement.
+    *
+    * \param std::string& key What was measured
+    * \param std::string& value The measured value including its unit
+    **/
+    void addValue(const std::string& key, const std::string& value);
+    /// Writes all entries to the given stream.
+    void print(std::ostream& output) const;
+    /// Removes all entries, e.g. before the next job of a server.
+    void clear();
+    /// The number of entries so far, see truncate.
+    std::size_t getEntryCount() const;
+    /// Removes the entries added after the first count, e.g. the stages of every single probe of a batch.
+    void truncate(std::size_t count);
+
+    /// Formats a byte count as MB with one decimal.
+    static std::string formatBytes(std::size_t bytes);
+
+private:
+    /// The collected entries as key value pairs.
+    std::vector<std::pair<std::string, std::string>> entries;
+};
+
+#endif // REPORT_H
@@ -0,0 +1,81 @@
+// Include own header
+#include "./sampleSchedule.h"
+// Include standard libraries
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+    const double PI = 3.14159265358979;
+}
+
+bool sampleSchedule::parse(const std::string& text, Spec& spec) {
+    if (text == "full") {
+        spec.mode = Spec::Mode::Full;
+        return true;
+    }
+    if (text == "auto") {
+        spec.mode = Spec::Mode::Auto;
+        return true;
+    }
+    std::vector<unsigned int> counts;
+    std::stringstream list(text);
+    std::string count;
+    while (std::getline(list, count, ',')) {
+        const int value = atoi(count.c_str());
+        if (value <= 0) {
+            return false;
+        }
+        counts.push_back((unsigned int)value);
+    }
+    if (counts.empty()) {
+        return false;
+    }
+    spec.mode = Spec::Mode::Fixed;
+    spec.counts = counts;
+    return true;
+}
+
+unsigned int sampleSchedule::automatic(float roughness, unsigned int faceSize) {
+    if (roughness == 0.0f) {
+        return 1;
+    }
+    // The reflected lobe is about twice as wide as the GGX lobe of the half vectors with alpha = roughness^2
+    const double alpha = double(roughness) * roughness;
+    const double lobe = std::min(4.0 * PI * alpha * alpha, 2.0 * PI);
+    const double texel = 4.0 * PI / (6.0 * double(faceSize) * faceSize);
+    const double wanted = samplesPerTexelRadius * std::sqrt(lobe / texel);
+    unsigned int count = minSamples;
+    while (count < wanted && count < fullSamples) {
+        count *= 2;
+    }
+    return count;
+}
+
+std::vector<unsigned int> sampleSchedule::build(const Spec& spec, unsigned int faceSize, unsigned int levels) {
+    std::vector<unsigned int> counts;
+    for (unsigned int level = 0; level < levels; ++level) {
+        const float roughness = levels > 1 ? float(level) / float(levels - 1) : 0.0f;
+        switch (spec.mode) {
+        case Spec::Mode::Full:
+            counts.push_back(fullSamples);
+            break;
+        case Spec::Mode::Auto:
+            counts.push_back(automatic(roughness, faceSize));
+            break;
+        case Spec::Mode::Fixed:
+            counts.push_back(spec.counts[std::min<std::size_t>(level, spec.counts.size() - 1)]);
+            break;
+        }
+    }
+    return counts;
+}
+
+std::string sampleSchedule::describe(const std::vector<unsigned int>& counts) {
+    std::ostringstream text;
+    for (std::size_t level = 0; level < counts.size(); ++level) {
+        text << (level > 0 ? ", " : "") << counts[level];
+    }
+    return text.str();
+}
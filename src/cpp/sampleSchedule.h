@@ -0,0 +1,61 @@
+#ifndef SAMPLESCHEDULE_H
+#define SAMPLESCHEDULE_H
+
+// Include standard libraries
+#include <string>
+#include <vector>
+
+/**
+* The number of GGX samples per prefiltered level.
+*
+* Every sample is looked up at the source LOD whose texels cover the solid angle of the sample, lobe / N, so fewer
+* samples do not alias but blur: the result drifts from the full count the more source detail the lobe holds. The
+* automatic schedule therefore grows the count with the radius of the lobe in source texels, the square root of its
+* solid angle over the solid angle of a source texel. The factor keeps the rms error against fullSamples at about 1%
+* on typical HDR sources, see -sample-error. Counts are powers of two between minSamples and fullSamples.
+**/
+namespace sampleSchedule {
+    /// The sample count of the shader and of the reference, SAMPLE_COUNT of prefilterEnvIBL.frag.glsl.
+    const unsigned int fullSamples = 8192;
+    /// The fewest samples the automatic schedule uses for a rough level.
+    const unsigned int minSamples = 64;
+
+    /// How the counts are chosen.
+    struct Spec {
+        enum class Mode {Full, Auto, Fixed};
+        Mode mode = Mode::Full;
+        /// The counts of Mode::Fixed, the last one repeats for further levels.
+        std::vector<unsigned int> counts;
+    };
+
+    /**
+    * Reads a schedule from the command line.
+    *
+    * \param const std::string& text "full", "auto", a count for all levels or a comma separated count per level
+    * \param Spec& spec Receives the schedule
+    * \return false if the text is no schedule
+    **/
+    bool parse(const std::string& text, Spec& spec);
+    /// Samples per lobe radius in source texels of the automatic schedule.
+    const double samplesPerTexelRadius = 40.0;
+
+    /**
+    * The automatic count of a level.
+    *
+    * \param float roughness The roughness of the level, 0 needs a single sample
+    * \param unsigned int faceSize The side width of the source cube
+    **/
+    unsigned int automatic(float roughness, unsigned int faceSize);
+    /**
+    * The counts of all levels of a prefiltered chain. Level i has roughness i / (levels - 1).
+    *
+    * \param const Spec& spec The schedule
+    * \param unsigned int faceSize The side width of level 0
+    * \param unsigned int levels The number of levels
+    **/
+    std::vector<unsigned int> build(const Spec& spec, unsigned int faceSize, unsigned int levels);
+    /// The counts as a comma separated list for the report.
+    std::string describe(const std::vector<unsigned int>& counts);
+}
+
+#endif // SAMPLESCHEDULE_H
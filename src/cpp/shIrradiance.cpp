@@ -0,0 +1,90 @@
+// Include own header
+#include "./shIrradiance.h"
+#include "./faceTables.h"
+#include "./parallel.h"
+// Include standard libraries
+#include <algorithm>
+#include <memory>
+
+namespace {
+    /// The 9 real basis functions at a normalized direction.
+    void basis(float x, float y, float z, float* Y) {
+        Y[0] = 0.282095f;
+        Y[1] = 0.488603f * y;
+        Y[2] = 0.488603f * z;
+        Y[3] = 0.488603f * x;
+        Y[4] = 1.092548f * x * y;
+        Y[5] = 1.092548f * y * z;
+        Y[6] = 0.315392f * (3.0f * z * z - 1.0f);
+        Y[7] = 1.092548f * x * z;
+        Y[8] = 0.546274f * (x * x - y * y);
+    }
+}
+
+unsigned int shIrradiance::projectionLevel(unsigned int size) {
+    unsigned int level = 0;
+    while ((size >> level) > projectionSize) {
+        level++;
+    }
+    return level;
+}
+
+shIrradiance::Coefficients shIrradiance::project(const CubeImage& cube, unsigned int level, Report& report) {
+    const unsigned int size = cube.getSize(level);
+    const std::shared_ptr<const FaceTables> tables = FaceTables::get(size, report);
+    // Every face sums on its own in double, the faces are added at the end
+    double sums[6][9][3] = {};
+    parallel::forEach(6, [&](unsigned int face) {
+        const ConstImageView texels = cube.getFace(level, face);
+        for (unsigned int y = 0; y < size; ++y) {
+            for (unsigned int x = 0; x < size; ++x) {
+                const std::size_t i = std::size_t(y) * size + x;
+                float Y[9];
+                basis(tables->getX(face)[i], tables->getY(face)[i], tables->getZ(face)[i], Y);
+                const float solidAngle = tables->getSolidAngle(face)[i];
+                for (unsigned int c = 0; c < 3; ++c) {
+                    const double weighted = double(texels.at(c, x, y)) * solidAngle;
+                    for (unsigned int k = 0; k < 9; ++k) {
+                        sums[face][k][c] += weighted * Y[k];
+                    }
+                }
+            }
+        }
+    });
+    Coefficients radiance;
+    for (unsigned int k = 0; k < 9; ++k) {
+        for (unsigned int c = 0; c < 3; ++c) {
+            double sum = 0.0;
+            for (unsigned int face = 0; face < 6; ++face) {
+                sum += sums[face][k][c];
+            }
+            radiance.rgb[k][c] = float(sum);
+        }
+    }
+    return radiance;
+}
+
+void shIrradiance::evaluate(const Coefficients& radiance, CubeImage& target, Report& report) {
+    const unsigned int size = target.getSize();
+    const std::shared_ptr<const FaceTables> tables = FaceTables::get(size, report);
+    // The clamped cosine per band, divided by PI for the scale of the convolution shader
+    const float band[9] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+    parallel::forEach(6 * size, [&](unsigned int item) {
+        const unsigned int face = item / size;
+        const unsigned int y = item % size;
+        const ImageView texels = target.getFace(0, face);
+        for (unsigned int x = 0; x < size; ++x) {
+            const std::size_t i = std::size_t(y) * size + x;
+            float Y[9];
+            basis(tables->getX(face)[i], tables->getY(face)[i], tables->getZ(face)[i], Y);
+            for (unsigned int c = 0; c < 3; ++c) {
+                float sum = 0.0f;
+                for (unsigned int k = 0; k < 9; ++k) {
+                    sum += band[k] * radiance.rgb[k][c] * Y[k];
+                }
+                // Ringing of the truncated series can go slightly below 0 next to very bright spots
+                texels.at(c, x, y) = std::max(sum, 0.0f);
+            }
+        }
+    });
+}
@@ -0,0 +1,50 @@
+#ifndef SHIRRADIANCE_H
+#define SHIRRADIANCE_H
+
+// Include own classes
+#include "./cubeImage.h"
+#include "./report.h"
+
+/**
+* \brief The irradiance map from the order 2 spherical harmonics of the background.
+*
+* Irradiance only has low frequencies, so the 9 coefficients of the radiance are enough to evaluate it within a few
+* percent (Ramamoorthi and Hanrahan, An Efficient Representation for Irradiance Environment Maps). The radiance is
+* projected from a small level of the background, weighting every texel with its solid angle from FaceTables, and the
+* irradiance texels are evaluated from the coefficients convolved with the clamped cosine. The result is scaled like
+* diffuseIBL.frag.glsl, irradiance / PI. Both passes take a few milliseconds instead of a hemisphere loop per texel.
+**/
+namespace shIrradiance {
+    /// The largest side width the radiance is projected from.
+    const unsigned int projectionSize = 64;
+
+    /// The radiance coefficients, RGB each, in the order Y00, Y1-1, Y10, Y11, Y2-2, Y2-1, Y20, Y21, Y22.
+    struct Coefficients {
+        float rgb[9][3];
+    };
+
+    /**
+    * The first level of a cube with at most projectionSize texels side width.
+    *
+    * \param unsigned int size The side width of level 0
+    **/
+    unsigned int projectionLevel(unsigned int size);
+    /**
+    * Projects a level of a cube onto the spherical harmonics.
+    *
+    * \param const CubeImage& cube The radiance
+    * \param unsigned int level The level to project, see projectionLevel
+    * \param Report& report Receives the face tables build time if they are not cached
+    **/
+    Coefficients project(const CubeImage& cube, unsigned int level, Report& report);
+    /**
+    * Writes the irradiance to level 0 of a cube.
+    *
+    * \param const Coefficients& radiance The projected radiance
+    * \param CubeImage& target The irradiance map
+    * \param Report& report Receives the face tables build time if they are not cached
+    **/
+    void evaluate(const Coefficients& radiance, CubeImage& target, Report& report);
+}
+
+#endif // SHIRRADIANCE_H
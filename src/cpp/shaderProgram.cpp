@@ -0,0 +1,82 @@
+// Include own header
+#include "./shaderProgram.h"
+// Include standard libraries
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+ShaderProgram::ShaderProgram(GLHandle program) : program(std::move(program)) {
+    const GLuint id = this->program.get();
+    if (id == 0) {
+        return;
+    }
+    GLint linked = 0;
+    glGetProgramiv(id, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        return;
+    }
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<GLchar> name(std::max(maxLength, 1));
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(id, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, name.data());
+        const std::string uniform(name.data(), length);
+        // Members of uniform blocks have no location
+        const GLint location = glGetUniformLocation(id, uniform.c_str());
+        if (location != -1) {
+            this->locations[uniform] = location;
+        }
+    }
+}
+
+GLuint ShaderProgram::get() const {
+    return this->program.get();
+}
+
+void ShaderProgram::use() const {
+    glUseProgram(this->program.get());
+}
+
+GLint ShaderProgram::getLocation(const std::string& name) const {
+    auto found = this->locations.find(name);
+    return found != this->locations.end() ? found->second : -1;
+}
+
+void ShaderProgram::bindUniformBlock(const std::string& name, GLuint binding) const {
+    if (this->program.get() == 0) {
+        return;
+    }
+    const GLuint index = glGetUniformBlockIndex(this->program.get(), name.c_str());
+    if (index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(this->program.get(), index, binding);
+    }
+}
+
+void ShaderProgram::setInt(GLint location, int value) const {
+    glUniform1i(location, value);
+}
+
+void ShaderProgram::setFloat(GLint location, float value) const {
+    glUniform1f(location, value);
+}
+
+void ShaderProgram::setMat4(GLint location, const glm::mat4& value) const {
+    glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+void ShaderProgram::setInt(const std::string& name, int value) const {
+    this->setInt(this->getLocation(name), value);
+}
+
+void ShaderProgram::setFloat(const std::string& name, float value) const {
+    this->setFloat(this->getLocation(name), value);
+}
+
+void ShaderProgram::setMat4(const std::string& name, const glm::mat4& value) const {
+    this->setMat4(this->getLocation(name), value);
+}
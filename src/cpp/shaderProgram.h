@@ -0,0 +1,68 @@
+#ifndef SHADERPROGRAM_H
+#define SHADERPROGRAM_H
+
+// Include standard libraries
+#include <map>
+#include <string>
+// Include glad for OpenGL function pointers
+#include "glad/glad.h"
+// Include glm for vector and matrix operations
+#include "glm/glm.hpp"
+// Include own classes
+#include "./glResources.h"
+
+/**
+* \class ShaderProgram
+*
+* \brief A linked program with the locations of its uniforms resolved once.
+*
+* The Shader class of learnopengl asks glGetUniformLocation with a string on every set call. This class queries
+* all active uniforms when it takes the program, so setting a uniform by name is a map lookup without any GL
+* round trip, and loops can keep a location from getLocation and set it directly. The program is deleted with
+* the object, so the context has to be current then.
+**/
+class ShaderProgram {
+public:
+    /// An empty program.
+    ShaderProgram() {}
+    /**
+    * Takes a linked program and resolves its uniform locations.
+    *
+    * \param GLHandle program The program, a failed link gives a program without uniforms
+    **/
+    explicit ShaderProgram(GLHandle program);
+
+    /// The program name, 0 if the program is empty.
+    GLuint get() const;
+    /// Makes the program current.
+    void use() const;
+    /**
+    * The location of an active uniform.
+    *
+    * \param const std::string& name The name, for arrays the name of the first element like "views[0]"
+    * \return The location or -1 if the program has no such active uniform
+    **/
+    GLint getLocation(const std::string& name) const;
+    /**
+    * Connects a uniform block of the program to a binding point. Does nothing if the program has no such block.
+    *
+    * \param const std::string& name The name of the block
+    * \param GLuint binding The binding point the buffer is bound to with glBindBufferBase
+    **/
+    void bindUniformBlock(const std::string& name, GLuint binding) const;
+
+    // The program has to be current for all setters, -1 locations are ignored like by OpenGL.
+    void setInt(GLint location, int value) const;
+    void setFloat(GLint location, float value) const;
+    void setMat4(GLint location, const glm::mat4& value) const;
+    void setInt(const std::string& name, int value) const;
+    void setFloat(const std::string& name, float value) const;
+    void setMat4(const std::string& name, const glm::mat4& value) const;
+
+private:
+    GLHandle program;
+    /// The active uniforms by name.
+    std::map<std::string, GLint> locations;
+};
+
+#endif // SHADERPROGRAM_H
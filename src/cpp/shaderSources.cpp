@@ -0,0 +1,37 @@
+// Include own header
+#include "./shaderSources.h"
+// Include standard libraries
+#include <fstream>
+#include <sstream>
+
+namespace {
+    struct EmbeddedSource {
+        const char* name;
+        const char* code;
+    };
+
+#include "./glslSources.inl"
+
+    std::string overrideDirectory;
+}
+
+void shaderSources::setOverrideDirectory(const std::string& directory) {
+    overrideDirectory = directory;
+}
+
+std::string shaderSources::get(const std::string& name) {
+    if (!overrideDirectory.empty()) {
+        std::ifstream file(overrideDirectory + "/" + name, std::ios::binary);
+        if (file) {
+            std::stringstream content;
+            content << file.rdbuf();
+            return content.str();
+        }
+    }
+    for (const EmbeddedSource& source : embeddedSources) {
+        if (name == source.name) {
+            return source.code;
+        }
+    }
+    return std::string();
+}
@@ -0,0 +1,29 @@
+#ifndef SHADERSOURCES_H
+#define SHADERSOURCES_H
+
+// Include standard libraries
+#include <string>
+
+/**
+* The GLSL sources of src/glsl, embedded at build time by tools/embedGlsl.py.
+*
+* Programs do not depend on the working directory and starting needs no file IO. For shader development an
+* override directory can be set, files found there replace the embedded ones.
+**/
+namespace shaderSources {
+    /**
+    * Sets the directory whose files replace the embedded sources of the same name.
+    *
+    * \param const std::string& directory The directory, empty to use only the embedded sources
+    **/
+    void setOverrideDirectory(const std::string& directory);
+    /**
+    * The source of a shader.
+    *
+    * \param const std::string& name The file name in src/glsl, e.g. "std.vert.glsl"
+    * \return The source or an empty string if there is no such shader
+    **/
+    std::string get(const std::string& name);
+}
+
+#endif // SHADERSOURCES_H
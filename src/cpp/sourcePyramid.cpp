@@ -0,0 +1,151 @@
+// Include own header
+#include "./sourcePyramid.h"
+// Include standard libraries
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const double PI = 3.14159265358979;
+
+    /// A view of one row.
+    template <typename T>
+    PlanarView<T> rowOf(const PlanarView<T>& view, unsigned int y) {
+        return PlanarView<T>(view.row(0, y), view.width, 1, view.stride, view.planeStride);
+    }
+}
+
+SourcePyramid::SourcePyramid(const ConstImageView& source, Arena& arena) {
+    const ArenaScope scope(arena);
+    unsigned int width = source.width;
+    unsigned int height = source.height;
+    PlanarImage iso(width, height, &arena);
+    for (unsigned int c = 0; c < 3; ++c) {
+        for (unsigned int y = 0; y < height; ++y) {
+            std::copy(source.row(c, y), source.row(c, y) + width, iso.getView().row(c, y));
+        }
+    }
+    while (true) {
+        PlanarImage level(width, height);
+        const ConstImageView src = iso.getView();
+        const ImageView filtered = level.getView();
+        for (unsigned int y = 0; y < height; ++y) {
+            filterRow(rowOf(src, y), rowOf(filtered, y), y, height);
+        }
+        this->levels.push_back(std::move(level));
+        if (width == 1 && height == 1) {
+            break;
+        }
+        // Isotropic 2x2 reduction for the next level. Odd sizes are rounded down like OpenGL does.
+        const unsigned int nextWidth = std::max(width / 2, 1u);
+        const unsigned int nextHeight = std::max(height / 2, 1u);
+        const unsigned int stepY = height > 1 ? 2 : 1;
+        PlanarImage next(nextWidth, nextHeight, &arena);
+        const ImageView dst = next.getView();
+        for (unsigned int y = 0; y < nextHeight; ++y) {
+            reduceRows(rowOf(src, y * stepY), rowOf(src, y * stepY + stepY - 1), rowOf(dst, y));
+        }
+        iso = std::move(next);
+        width = nextWidth;
+        height = nextHeight;
+    }
+}
+
+unsigned int SourcePyramid::getLevelCount() const {
+    return (unsigned int)this->levels.size();
+}
+
+unsigned int SourcePyramid::getWidth(unsigned int level) const {
+    return this->levels[level].getWidth();
+}
+
+unsigned int SourcePyramid::getHeight(unsigned int level) const {
+    return this->levels[level].getHeight();
+}
+
+ConstImageView SourcePyramid::getLevel(unsigned int level) const {
+    return this->levels[level].getView();
+}
+
+void SourcePyramid::sample(float u, float v, float lod, float* rgb) const {
+    lod = std::min(std::max(lod, 0.0f), float(this->levels.size() - 1));
+    const unsigned int level = (unsigned int)lod;
+    const float t = lod - level;
+    this->sampleLevel(level, u, v, rgb);
+    if (t > 0.0f) {
+        float next[3];
+        this->sampleLevel(level + 1, u, v, next);
+        for (int c = 0; c < 3; ++c) {
+            rgb[c] += (next[c] - rgb[c]) * t;
+        }
+    }
+}
+
+void SourcePyramid::sampleLevel(unsigned int level, float u, float v, float* rgb) const {
+    const ConstImageView src = this->levels[level].getView();
+    const float px = u * src.width - 0.5f;
+    const float py = v * src.height - 0.5f;
+    const int x0 = int(std::floor(px));
+    const int y0 = int(std::floor(py));
+    const float fx = px - x0;
+    const float fy = py - y0;
+    // Repeat horizontally, clamp vertically
+    const int w = src.width;
+    const unsigned int xa = ((x0 % w) + w) % w;
+    const unsigned int xb = (xa + 1) % w;
+    const unsigned int ya = std::min(std::max(y0, 0), int(src.height) - 1);
+    const unsigned int yb = std::min(std::max(y0 + 1, 0), int(src.height) - 1);
+    for (unsigned int c = 0; c < 3; ++c) {
+        const float* row0 = src.row(c, ya);
+        const float* row1 = src.row(c, yb);
+        const float bottom = row0[xa] + (row0[xb] - row0[xa]) * fx;
+        const float top = row1[xa] + (row1[xb] - row1[xa]) * fx;
+        rgb[c] = bottom + (top - bottom) * fy;
+    }
+}
+
+void SourcePyramid::filterRow(const ConstImageView& src, const ImageView& dst, unsigned int y, unsigned int height) {
+    const unsigned int width = dst.width;
+    const double latitude = ((y + 0.5) / height - 0.5) * PI;
+    const double boxWidth = std::min(1.0 / std::cos(latitude), double(width));
+    // The integral of a row, from the scratch arena of the thread, this runs for every row of every level
+    Arena& scratch = Arena::scratch();
+    const ArenaScope scope(scratch);
+    double* prefix = (double*)scratch.allocate((std::size_t(width) + 1) * sizeof(double));
+    for (unsigned int c = 0; c < 3; ++c) {
+        const float* row = src.row(c, 0);
+        float* out = dst.row(c, 0);
+        if (boxWidth <= 1.0001) {
+            std::copy(row, row + width, out);
+            continue;
+        }
+        // Box filter with a fractional width through the integral of the row, wrapping around at the seam
+        prefix[0] = 0.0;
+        for (unsigned int x = 0; x < width; ++x) {
+            prefix[x + 1] = prefix[x] + row[x];
+        }
+        auto integral = [&](double t) {
+            const double turns = std::floor(t / width);
+            const double rest = t - turns * width;
+            const unsigned int i = std::min((unsigned int)rest, width - 1);
+            return turns * prefix[width] + prefix[i] + (rest - i) * row[i];
+        };
+        for (unsigned int x = 0; x < width; ++x) {
+            const double center = x + 0.5;
+            out[x] = float((integral(center + 0.5 * boxWidth) - integral(center - 0.5 * boxWidth)) / boxWidth);
+        }
+    }
+}
+
+void SourcePyramid::reduceRows(const ConstImageView& row0, const ConstImageView& row1, const ImageView& dst) {
+    const unsigned int stepX = row0.width > 1 ? 2 : 1;
+    for (unsigned int c = 0; c < 3; ++c) {
+        const float* in0 = row0.row(c, 0);
+        const float* in1 = row1.row(c, 0);
+        float* out = dst.row(c, 0);
+        for (unsigned int x = 0; x < dst.width; ++x) {
+            const unsigned int x0 = x * stepX;
+            const unsigned int x1 = x * stepX + stepX - 1;
+            out[x] = 0.25f * (in0[x0] + in0[x1] + in1[x0] + in1[x1]);
+        }
+    }
+}
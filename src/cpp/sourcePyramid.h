@@ -0,0 +1,80 @@
+#ifndef SOURCEPYRAMID_H
+#define SOURCEPYRAMID_H
+
+// Include standard libraries
+#include <vector>
+// Include own classes
+#include "./arena.h"
+#include "./planarImage.h"
+
+/**
+* \class SourcePyramid
+*
+* \brief A mip chain for equirectangular images which respects the latitude of every row.
+*
+* A plain box filtered mip chain treats every texel as equally big. On the sphere an equirectangular texel gets
+* narrower towards the poles by cos(latitude), so a cube face texel covers more source columns there than rows.
+* Every level of this pyramid is first reduced isotropically (2x2 box) and then each row is blurred horizontally
+* with a box of 1/cos(latitude) texels, wrapping around at the seam. After that a single lookup whose LOD is
+* chosen from the vertical footprint of a texel is alias free at any latitude.
+*
+* Levels are planar RGB images. The row order does not matter since the filter is symmetric to the equator.
+**/
+class SourcePyramid {
+public:
+    /**
+    * \brief Builds the complete chain down to 1x1.
+    *
+    * \param const ConstImageView& source The source pixels
+    * \param Arena& arena Supplies the intermediate levels, it is rewound when done
+    **/
+    SourcePyramid(const ConstImageView& source, Arena& arena);
+
+    /// The number of levels including level 0.
+    unsigned int getLevelCount() const;
+    /// The width of the given level.
+    unsigned int getWidth(unsigned int level) const;
+    /// The height of the given level.
+    unsigned int getHeight(unsigned int level) const;
+    /// The planes of the given level.
+    ConstImageView getLevel(unsigned int level) const;
+    /**
+    * Trilinear lookup like an OpenGL texture which repeats horizontally and clamps vertically.
+    *
+    * \param float u The horizontal texture coordinate, row 0 is at v = 0
+    * \param float v The vertical texture coordinate
+    * \param float lod The level, clamped to the existing ones
+    * \param float* rgb Receives the color
+    **/
+    void sample(float u, float v, float lod, float* rgb) const;
+
+    /**
+    * Blurs one row of an isotropic level with a box of 1/cos(latitude) texels like every row of a level, for
+    * callers which build the levels row by row, e.g. CpuConverter.
+    *
+    * \param const ConstImageView& src The isotropic row
+    * \param const ImageView& dst Receives the filtered row, same width as src
+    * \param unsigned int y The index of the row in its level
+    * \param unsigned int height The height of the level
+    **/
+    static void filterRow(const ConstImageView& src, const ImageView& dst, unsigned int y, unsigned int height);
+    /**
+    * Reduces two rows of an isotropic level to a row of the next level like the constructor does. Odd widths are
+    * rounded down like OpenGL does.
+    *
+    * \param const ConstImageView& row0 The first row
+    * \param const ConstImageView& row1 The second row, the first one again if the level is one row high
+    * \param const ImageView& dst Receives max(width / 2, 1) texels
+    **/
+    static void reduceRows(const ConstImageView& row0, const ConstImageView& row1, const ImageView& dst);
+
+private:
+    /// All levels starting with the full resolution.
+    std::vector<PlanarImage> levels;
+
+    /// Bilinear lookup in one level.
+    void sampleLevel(unsigned int level, float u, float v, float* rgb) const;
+
+};
+
+#endif // SOURCEPYRAMID_H
@@ -0,0 +1,149 @@
+// Include own header
+#include "./taskScheduler.h"
+#include "./parallel.h"
+// Include standard libraries
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+double TaskScheduler::Stats::imbalance() const {
+    if (this->busyMs.empty()) {
+        return 1.0;
+    }
+    const double mean = std::accumulate(this->busyMs.begin(), this->busyMs.end(), 0.0) / this->busyMs.size();
+    return mean > 0.0 ? *std::max_element(this->busyMs.begin(), this->busyMs.end()) / mean : 1.0;
+}
+
+void TaskScheduler::Stats::addTo(Report& report, const std::string& name) const {
+    report.addValue(name + " threads", std::to_string(this->busyMs.size()));
+    report.addValue(name + " tasks", std::to_string(this->tasks));
+    report.addValue(name + " steals", std::to_string(this->steals));
+    std::ostringstream balance;
+    balance << std::fixed << std::setprecision(2) << this->imbalance() << " (busiest thread / mean)";
+    report.addValue(name + " load imbalance", balance.str());
+}
+
+TaskScheduler::TaskScheduler(unsigned int threads) {
+    if (threads == 0) {
+        threads = parallel::threadCount();
+    }
+    for (unsigned int i = 0; i < threads; ++i) {
+        this->workers.emplace_back(new Worker());
+    }
+    for (unsigned int i = 1; i < threads; ++i) {
+        this->threads.emplace_back(&TaskScheduler::helper, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stop = true;
+    }
+    this->wake.notify_all();
+    for (auto& thread : this->threads) {
+        thread.join();
+    }
+}
+
+unsigned int TaskScheduler::getThreadCount() const {
+    return (unsigned int)this->workers.size();
+}
+
+TaskScheduler::Stats TaskScheduler::run(std::vector<Task>& tasks) {
+    Timer timer;
+    // Longest processing time first onto the least loaded deque
+    std::vector<Task*> order;
+    for (auto& task : tasks) {
+        order.push_back(&task);
+    }
+    std::stable_sort(order.begin(), order.end(), [](const Task* t0, const Task* t1) { return t0->cost > t1->cost; });
+    std::vector<double> load(this->workers.size(), 0.0);
+    for (auto& worker : this->workers) {
+        worker->tasks.clear();
+        worker->busyMs = 0.0;
+        worker->executed = 0;
+        worker->steals = 0;
+    }
+    for (Task* task : order) {
+        const std::size_t target = std::min_element(load.begin(), load.end()) - load.begin();
+        this->workers[target]->tasks.push_back(task);
+        load[target] += task->cost;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->finished = 0;
+        this->generation++;
+    }
+    this->wake.notify_all();
+    this->work(0);
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->done.wait(lock, [this]() { return this->finished == this->threads.size(); });
+    }
+
+    Stats stats;
+    for (auto& worker : this->workers) {
+        stats.tasks += worker->executed;
+        stats.steals += worker->steals;
+        stats.busyMs.push_back(worker->busyMs);
+    }
+    stats.wallMs = timer.elapsedMs();
+    return stats;
+}
+
+void TaskScheduler::helper(unsigned int index) {
+    unsigned int seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->wake.wait(lock, [&]() { return this->stop || this->generation != seen; });
+            if (this->stop) {
+                return;
+            }
+            seen = this->generation;
+        }
+        this->work(index);
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->finished++;
+        }
+        this->done.notify_one();
+    }
+}
+
+void TaskScheduler::work(unsigned int index) {
+    Worker& worker = *this->workers[index];
+    // No task adds new ones, so once every deque is empty there is nothing left to do
+    for (Task* task = this->next(index); task != nullptr; task = this->next(index)) {
+        Timer timer;
+        task->work();
+        worker.busyMs += timer.elapsedMs();
+        worker.executed++;
+    }
+}
+
+TaskScheduler::Task* TaskScheduler::next(unsigned int index) {
+    Worker& own = *this->workers[index];
+    {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            Task* task = own.tasks.front();
+            own.tasks.pop_front();
+            return task;
+        }
+    }
+    for (std::size_t i = 1; i < this->workers.size(); ++i) {
+        Worker& victim = *this->workers[(index + i) % this->workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            Task* task = victim.tasks.back();
+            victim.tasks.pop_back();
+            own.steals++;
+            return task;
+        }
+    }
+    return nullptr;
+}
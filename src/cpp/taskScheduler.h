@@ -0,0 +1,106 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+// Include standard libraries
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+// Include own classes
+#include "./report.h"
+
+/**
+* \class TaskScheduler
+*
+* \brief A thread pool with one deque per thread which balances tasks of different cost by work stealing.
+*
+* Before a run the tasks are placed on the deques by their estimated cost, the most expensive first onto the least
+* loaded deque. A thread takes the most expensive task of its own deque. When its deque is empty it steals the
+* cheapest task from the back of another one, so estimation errors are balanced out with small tasks at the end.
+* The calling thread works as thread 0.
+**/
+class TaskScheduler {
+public:
+    /// A unit of work together with its estimated cost in arbitrary units.
+    struct Task {
+        std::function<void()> work;
+        double cost;
+    };
+
+    /// The measurements of a run.
+    struct Stats {
+        /// The number of tasks executed.
+        unsigned int tasks = 0;
+        /// The number of tasks taken from another threads deque.
+        unsigned int steals = 0;
+        /// The time from the start to the end of the run.
+        double wallMs = 0.0;
+        /// The time every thread spent in tasks.
+        std::vector<double> busyMs;
+
+        /// The busy time of the busiest thread divided by the mean, 1 is perfectly balanced.
+        double imbalance() const;
+        /**
+        * Adds the measurements to a report.
+        *
+        * \param Report& report The report
+        * \param std::string& name Prefix of the entries
+        **/
+        void addTo(Report& report, const std::string& name) const;
+    };
+
+    /**
+    * Starts the worker threads.
+    *
+    * \param unsigned int threads The number of threads including the calling one. 0 uses parallel::threadCount().
+    **/
+    explicit TaskScheduler(unsigned int threads = 0);
+    /// Stops and joins the worker threads.
+    ~TaskScheduler();
+
+    /// The number of threads including the calling one.
+    unsigned int getThreadCount() const;
+    /**
+    * Runs all tasks and returns when they are done.
+    *
+    * \param std::vector<Task>& tasks The tasks. They must not add further tasks.
+    * \return The measurements of this run
+    **/
+    Stats run(std::vector<Task>& tasks);
+
+private:
+    /// The deque and the counters of one thread.
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task*> tasks;
+        double busyMs = 0.0;
+        unsigned int executed = 0;
+        unsigned int steals = 0;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    /// Signals the helper threads that a run started or the pool stops.
+    std::condition_variable wake;
+    /// Signals the calling thread that a helper finished its part of a run.
+    std::condition_variable done;
+    /// Incremented for every run, so helpers notice a new one.
+    unsigned int generation = 0;
+    /// The number of helpers which finished the current run.
+    unsigned int finished = 0;
+    bool stop = false;
+
+    /// The loop of a helper thread.
+    void helper(unsigned int index);
+    /// Executes tasks until no deque has one left.
+    void work(unsigned int index);
+    /// Takes a task from the front of the own deque or from the back of another one.
+    Task* next(unsigned int index);
+};
+
+#endif // TASKSCHEDULER_H
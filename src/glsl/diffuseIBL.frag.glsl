@@ -2,13 +2,26 @@
 
 /**
 * This shader is originally from https://learnopengl.com
+*
+* With PROBE_ARRAY defined it renders a batch of probes, see probe.geom.glsl, from the cubes of an array.
 **/
 
+#ifdef PROBE_ARRAY
+#extension GL_ARB_texture_cube_map_array : require
+#endif
+
 const float PI = 3.14159265359;
 
 out vec4 FragColor;
 in vec3 localPos;
+#ifdef PROBE_ARRAY
+flat in int probe;
+uniform samplerCubeArray environmentMap;
+#define SAMPLE_ENVIRONMENT(direction) texture(environmentMap, vec4(direction, float(probe)))
+#else
 uniform samplerCube environmentMap;
+#define SAMPLE_ENVIRONMENT(direction) texture(environmentMap, direction)
+#endif
 
 void main(){
     // the sample direction equals the hemisphere's orientation 
@@ -25,7 +38,7 @@ void main(){
             vec3 tangentSample = vec3(sin(theta) * cos(phi),  sin(theta) * sin(phi), cos(theta));
             // tangent space to world
             vec3 sampleVec = tangentSample.x * right + tangentSample.y * up + tangentSample.z * normal;
-                irradiance += texture(environmentMap, sampleVec).rgb * cos(theta) * sin(theta);
+                irradiance += SAMPLE_ENVIRONMENT(sampleVec).rgb * cos(theta) * sin(theta);
                 nrSamples++;
         }
     }
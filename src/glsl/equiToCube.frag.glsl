@@ -2,14 +2,28 @@
 
 /**
 * This shader is originally from https://learnopengl.com
+*
+* With PROBE_ARRAY defined it renders a batch of probes, see probe.geom.glsl, and the sources are the layers of an array.
 **/
 
 out vec4 FragColor;
 in vec3 localPos;
 
+#ifdef PROBE_ARRAY
+flat in int probe;
+uniform sampler2DArray equirectangularMap;
+#define SAMPLE_SOURCE(uv, lod) textureLod(equirectangularMap, vec3(uv, float(probe)), lod)
+#else
 uniform sampler2D equirectangularMap;
+#define SAMPLE_SOURCE(uv, lod) textureLod(equirectangularMap, uv, lod)
+#endif
+uniform float faceSize;  // width and height of the rendered cube faces
+uniform float srcHeight; // height of the equirectangular source at level 0
 
-const vec2 invAtan = vec2(0.1591, 0.3183);
+const float PI = 3.14159265359;
+
+// 1 / (2 PI) and 1 / PI. Four digits put the seam side of a 16k source almost 3 texels off.
+const vec2 invAtan = vec2(0.15915494, 0.31830989);
 vec2 SampleSphericalMap(vec3 v)
 {
     vec2 uv = vec2(atan(v.z, v.x), asin(v.y));
@@ -18,10 +32,21 @@ vec2 SampleSphericalMap(vec3 v)
     return uv;
 }
 
+// The angular size of the current face texel. On the unit cube a texel covers the solid angle
+// (2 / faceSize)^2 / |p|^3, the square root of it is the texels edge length on the sphere.
+float TexelAngle(vec3 v)
+{
+    vec3 p = v / max(max(abs(v.x), abs(v.y)), abs(v.z));
+    return 2.0 / faceSize * pow(dot(p, p), -0.75);
+}
+
 void main()
 {
     vec2 uv = SampleSphericalMap(normalize(localPos)); // make sure to normalize localPos
-    vec3 color = texture(equirectangularMap, uv).rgb;
+    // The source pyramid already compensates the horizontal stretching towards the poles,
+    // so the LOD follows from the texel angle compared to the height of a source texel.
+    float lod = max(log2(TexelAngle(localPos) * srcHeight / PI), 0.0);
+    vec3 color = SAMPLE_SOURCE(uv, lod).rgb;
 
     FragColor = vec4(color, 1.0);
 }
\ No newline at end of file
@@ -2,12 +2,37 @@
 
 /**
 * This shader is originally from https://learnopengl.com
+*
+* The loader specializes it per mip level by inserting defines after the version line:
+* ROUGHNESS_ZERO   the level is a plain copy of the environment, no samples are taken
+* ROUGHNESS [r]    the roughness is a constant instead of a uniform, so the compiler folds it
+* SAMPLE_COUNT [n] the number of samples, default 8192u
+* PROBE_ARRAY      a batch of probes is rendered, see probe.geom.glsl, from the cubes of an array
 **/
 
+#ifdef PROBE_ARRAY
+#extension GL_ARB_texture_cube_map_array : require
+#endif
+
+#ifndef SAMPLE_COUNT
+#define SAMPLE_COUNT 8192u
+#endif
+
 out vec4 FragColor;
 in vec3 localPos;
+#ifdef PROBE_ARRAY
+flat in int probe;
+uniform samplerCubeArray environmentMap;
+#define SAMPLE_ENVIRONMENT(direction, bias) texture(environmentMap, vec4(direction, float(probe)), bias)
+#else
 uniform samplerCube environmentMap;
+#define SAMPLE_ENVIRONMENT(direction, bias) texture(environmentMap, direction, bias)
+#endif
+#ifdef ROUGHNESS
+const float roughness = ROUGHNESS;
+#else
 uniform float roughness;
+#endif
 uniform float resolution; // resolution of source cubemap (per face)
 
 const float PI = 3.14159265359;
@@ -68,9 +93,12 @@ vec3 ImportanceSampleGGX(vec2 Xi, vec3 N, float roughness)
 void main()
 {
     vec3 N = normalize(localPos);
+#ifdef ROUGHNESS_ZERO
+    // Every sample would be the reflection itself with a mip bias of 0
+    FragColor = vec4(SAMPLE_ENVIRONMENT(N, 0.0).rgb, 1.0);
+#else
     vec3 R = N;
     vec3 V = R;
-    const uint SAMPLE_COUNT = 8192u;
     float totalWeight = 0.0;
     vec3 prefilteredColor = vec3(0.0);
     for(uint i = 0u; i < SAMPLE_COUNT; ++i)
@@ -92,11 +120,12 @@ void main()
                 mipLevel = 0.5 * log2(saSample / saTexel);
             }
 
-            prefilteredColor += texture(environmentMap, L, mipLevel).rgb * NdotL;
+            prefilteredColor += SAMPLE_ENVIRONMENT(L, mipLevel).rgb * NdotL;
             totalWeight      += NdotL;
         }
 
     }
     prefilteredColor = prefilteredColor / totalWeight;
     FragColor = vec4(prefilteredColor, 1.0);
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,32 @@
+#version 430 core
+
+// One invocation per cube face, so a single instanced draw renders every face of every probe of a batch
+layout (triangles, invocations = 6) in;
+layout (triangle_strip, max_vertices = 3) out;
+
+// Uploaded once per context, shared by all programs rendering cube faces
+layout (std140) uniform Capture
+{
+    mat4 projection;
+    mat4 views[6];
+};
+
+in vec3 vertexPos[];
+flat in int vertexProbe[];
+
+out vec3 localPos;
+flat out int probe;
+
+void main()
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        localPos = vertexPos[i];
+        probe = vertexProbe[0];
+        // The layers of a cube map array are the faces of one cube after the other
+        gl_Layer = vertexProbe[0] * 6 + gl_InvocationID;
+        gl_Position = projection * views[gl_InvocationID] * vec4(localPos, 1.0);
+        EmitVertex();
+    }
+    EndPrimitive();
+}
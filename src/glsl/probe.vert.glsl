@@ -0,0 +1,14 @@
+#version 430 core
+
+layout (location = 0) in vec3 aPos;
+
+// The geometry shader projects the cube once per face
+out vec3 vertexPos;
+flat out int vertexProbe;
+
+void main()
+{
+    vertexPos = aPos;
+    // One instance per probe of the batch
+    vertexProbe = gl_InstanceID;
+}
@@ -4,11 +4,17 @@ layout (location = 0) in vec3 aPos;
 
 out vec3 localPos;
 
-uniform mat4 projection;
-uniform mat4 view;
+// Uploaded once per context, shared by all programs rendering cube faces
+layout (std140) uniform Capture
+{
+    mat4 projection;
+    mat4 views[6];
+};
+// The cube face rendered, indexes views
+uniform int face;
 
 void main()
 {
     localPos = aPos;
-    gl_Position =  projection * view * vec4(localPos, 1.0);
+    gl_Position =  projection * views[face] * vec4(localPos, 1.0);
 }
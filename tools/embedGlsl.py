@@ -0,0 +1,38 @@
+#!/usr/bin/env python3
+"""Writes src/cpp/glslSources.inl with the content of every src/glsl/*.glsl file as a string constant.
+
+Run it after editing a shader and commit the result. While working on a shader, start the program with
+-glsl-dir src/glsl instead, so the files are read at runtime.
+"""
+import os
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GLSL_DIR = os.path.join(ROOT, "src", "glsl")
+OUTPUT = os.path.join(ROOT, "src", "cpp", "glslSources.inl")
+
+
+def literal(line):
+    escaped = line.replace("\\", "\\\\").replace("\"", "\\\"").replace("\t", "\\t").replace("\n", "\\n")
+    return "\"" + escaped + "\""
+
+
+def main():
+    names = sorted(name for name in os.listdir(GLSL_DIR) if name.endswith(".glsl"))
+    out = ["// Generated by tools/embedGlsl.py from src/glsl, do not edit.",
+           "// Included by shaderSources.cpp only.",
+           "",
+           "const EmbeddedSource embeddedSources[] = {"]
+    for name in names:
+        with open(os.path.join(GLSL_DIR, name), encoding="utf-8") as source:
+            # Line by line, so no literal gets near the length limit of MSVC
+            lines = source.read().replace("\r\n", "\n").splitlines(True)
+        out.append("    { \"" + name + "\",")
+        out.extend("        " + literal(line) for line in lines)
+        out.append("    },")
+    out.append("};")
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as header:
+        header.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()